@@ -5,6 +5,7 @@
 #include <eosio/chain/kv_chainbase_objects.hpp>
 #include <eosio/chain/backing_store/db_context.hpp>
 #include <eosio/chain/backing_store/db_key_value_format.hpp>
+#include <eosio/chain/thread_utils.hpp>
 
 namespace eosio { namespace chain {
    combined_session::combined_session(chainbase::database& cb_database, eosio::session::undo_stack<rocks_db_type>* undo_stack)
@@ -87,6 +88,43 @@ namespace eosio { namespace chain {
    template <typename F>
    void walk_index(const index_utils<kv_db_config_index>& utils, const chainbase::database& db, F&& function) {}
 
+   // Writes batches of key values to rocksdb on a separate thread while the next batch is read from the snapshot.
+   // At most one batch is written at a time, write() and wait() wait for the previous batch and rethrow its failure.
+   // One writer is used for the whole snapshot load, wait() must be called once all batches are written.
+   class async_kv_batch_writer {
+    public:
+      using batch_type = std::vector<std::pair<eosio::session::shared_bytes, eosio::session::shared_bytes>>;
+
+      explicit async_kv_batch_writer(rocks_db_type& kv_database)
+         : kv_database(kv_database) {}
+
+      // only reached with a batch in flight when the load already failed, that failure is the one reported
+      ~async_kv_batch_writer() {
+         if (pending.valid()) {
+            try {
+               pending.get();
+            } FC_LOG_AND_DROP()
+         }
+      }
+
+      void write(batch_type& batch) {
+         wait();
+         pending = async_thread_pool(thread_pool.get_executor(), [this, batch{std::move(batch)}]() {
+            kv_database.write(batch);
+         });
+         batch.clear();
+      }
+
+      void wait() {
+         if (pending.valid()) pending.get();
+      }
+
+    private:
+      rocks_db_type&     kv_database;
+      named_thread_pool  thread_pool{"snap", 1};
+      std::future<void>  pending;
+   };
+
    void add_kv_table_to_snapshot(const snapshot_writer_ptr& snapshot, const chainbase::database& db, const kv_undo_stack_ptr& kv_undo_stack) {
       snapshot->write_section<kv_object>([&db,&kv_undo_stack](auto& section) {
          if (kv_undo_stack && db.get<kv_db_config_object>().backing_store == backing_store_type::ROCKSDB) {
@@ -104,14 +142,15 @@ namespace eosio { namespace chain {
    }
 
    void read_kv_table_from_snapshot(const snapshot_reader_ptr& snapshot, chainbase::database& db,
-                                    const std::unique_ptr<rocks_db_type>& kv_database, uint32_t version, backing_store_type backing_store ) {
+                                    async_kv_batch_writer* kv_writer, uint32_t version, backing_store_type backing_store ) {
       if (version < kv_object::minimum_snapshot_version)
          return;
       if (backing_store == backing_store_type::ROCKSDB) {
-         auto key_values = std::vector<std::pair<eosio::session::shared_bytes, eosio::session::shared_bytes>>{};
+         auto key_values = async_kv_batch_writer::batch_type{};
+         auto& writer = *kv_writer;
          constexpr std::size_t batch_size = 500;
          key_values.reserve(batch_size);
-         snapshot->read_section<kv_object>([&key_values, &db, &kv_database](auto& section) {
+         snapshot->read_section<kv_object>([&key_values, &writer, &db](auto& section) {
             const std::string_view prefix_key {&backing_store::rocksdb_contract_kv_prefix, 1};
             bool more = !section.empty();
             while (more) {
@@ -135,13 +174,13 @@ namespace eosio { namespace chain {
                                        final_kv_value.as_payload());
 
                if (key_values.size() >= batch_size) {
-                  kv_database->write(key_values);
-                  key_values.clear();
+                  writer.write(key_values);
+                  key_values.reserve(batch_size);
                }
             }
          });
          // write out any remaining key-values
-         kv_database->write(key_values);
+         writer.write(key_values);
       }
       else {
          snapshot->read_section<kv_object>([&db](auto& section) {
@@ -497,8 +536,13 @@ namespace eosio { namespace chain {
          });
       });
 
-      read_kv_table_from_snapshot(snapshot, db, kv_database, header.version, backing_store);
-      read_contract_tables_from_snapshot(snapshot);
+      std::optional<async_kv_batch_writer> kv_writer;
+      if (backing_store == backing_store_type::ROCKSDB)
+         kv_writer.emplace(*kv_database);
+      read_kv_table_from_snapshot(snapshot, db, kv_writer ? &*kv_writer : nullptr, header.version, backing_store);
+      read_contract_tables_from_snapshot(snapshot, kv_writer ? &*kv_writer : nullptr);
+      if (kv_writer)
+         kv_writer->wait();
 
       authorization.read_from_snapshot(snapshot);
       resource_limits.read_from_snapshot(snapshot, header.version);
@@ -589,9 +633,9 @@ namespace eosio { namespace chain {
    }
 
    template <typename Section>
-   void rocksdb_read_contract_tables_from_snapshot(rocks_db_type& kv_database, chainbase::database& db,
+   void rocksdb_read_contract_tables_from_snapshot(async_kv_batch_writer& writer, chainbase::database& db,
                                                    Section& section, uint64_t snapshot_batch_threashold) {
-      std::vector<std::pair<eosio::session::shared_bytes, eosio::session::shared_bytes>> batch;
+      async_kv_batch_writer::batch_type batch;
       bool                more     = !section.empty();
       auto                read_row = [&section, &more, &db](auto& row) { more = section.read_row(row, db); };
       uint64_t            batch_mem_size = 0;
@@ -600,7 +644,7 @@ namespace eosio { namespace chain {
          // read the row for the table
          backing_store::table_id_object_view table_obj;
          read_row(table_obj);
-         auto put = [&batch, &table_obj, &batch_mem_size, &kv_database, snapshot_batch_threashold]
+         auto put = [&batch, &table_obj, &batch_mem_size, &writer, snapshot_batch_threashold]
                (auto&& value, auto create_fun, auto&&... args) {
             auto composite_key = create_fun(table_obj.scope, table_obj.table, std::forward<decltype(args)>(args)...);
             batch.emplace_back(backing_store::db_key_value_format::create_full_key(composite_key, table_obj.code),
@@ -609,9 +653,8 @@ namespace eosio { namespace chain {
             const auto& back = batch.back();
             const auto size = back.first.size() + back.second.size();
             if (size >= snapshot_batch_threashold || snapshot_batch_threashold - size < batch_mem_size) {
-               kv_database.write(batch);
+               writer.write(batch);
                batch_mem_size = 0;
-               batch.clear();
             }
             else {
                batch_mem_size += size;
@@ -654,13 +697,14 @@ namespace eosio { namespace chain {
          put(pp.as_payload(), create_table_key);
 
       }
-      kv_database.write(batch);
+      writer.write(batch);
    }
 
-   void combined_database::read_contract_tables_from_snapshot(const snapshot_reader_ptr& snapshot) {
-      snapshot->read_section("contract_tables", [this](auto& section) {
+   void combined_database::read_contract_tables_from_snapshot(const snapshot_reader_ptr& snapshot,
+                                                              async_kv_batch_writer* kv_writer) {
+      snapshot->read_section("contract_tables", [this, kv_writer](auto& section) {
          if (kv_undo_stack && db.get<kv_db_config_object>().backing_store == backing_store_type::ROCKSDB)
-            rocksdb_read_contract_tables_from_snapshot(*kv_database, db, section, kv_snapshot_batch_threashold);
+            rocksdb_read_contract_tables_from_snapshot(*kv_writer, db, section, kv_snapshot_batch_threashold);
          else
             chainbase_read_contract_tables_from_snapshot(db, section);
       });
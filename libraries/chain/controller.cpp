@@ -20,7 +20,9 @@
 #include <fc/variant_object.hpp>
 #include <b1/chain_kv/chain_kv.hpp>
 
+#include <condition_variable>
 #include <new>
+#include <thread>
 
 #if defined(EOSIO_EOS_VM_RUNTIME_ENABLED) || defined(EOSIO_EOS_VM_JIT_RUNTIME_ENABLED)
 #include <eosio/vm/allocator.hpp>
@@ -139,6 +141,100 @@ struct pending_state {
    }
 };
 
+/**
+ * Reads and unpacks blocks from the block log on a dedicated thread, up to max_blocks ahead of the block being
+ * replayed, so that disk reads and deserialization (including transaction id calculation) overlap block application.
+ * If a thread pool is provided, key recovery of each transaction is started on it as soon as its block is read.
+ * Must be the only reader of the block log while in use.
+ */
+class replay_read_ahead {
+public:
+   struct entry {
+      signed_block_ptr                                   block;
+      std::map<transaction_id_type, recover_keys_future> recovered_trxs;
+   };
+
+   replay_read_ahead( const block_log& blog, uint32_t start_block_num, size_t max_blocks,
+                      boost::asio::io_context* thread_pool, const chain_id_type& chain_id )
+   : blog( blog ), max_blocks( max_blocks ), thread_pool( thread_pool ), chain_id( chain_id )
+   {
+      reader = std::thread( [this, start_block_num]() { run( start_block_num ); } );
+   }
+
+   ~replay_read_ahead() {
+      {
+         std::lock_guard<std::mutex> g( mtx );
+         stopped = true;
+      }
+      cv.notify_all();
+      reader.join();
+   }
+
+   /// next block in order, empty at the end of the block log, rethrows any error reading the block log
+   std::optional<entry> next() {
+      std::unique_lock<std::mutex> g( mtx );
+      cv.wait( g, [this]() { return !blocks.empty() || done; } );
+      if( blocks.empty() ) {
+         if( except ) std::rethrow_exception( except );
+         return {};
+      }
+      entry e = std::move( blocks.front() );
+      blocks.pop_front();
+      g.unlock();
+      cv.notify_all();
+      return e;
+   }
+
+private:
+   void run( uint32_t block_num ) {
+      fc::set_os_thread_name( "replay-read" );
+      try {
+         while( std::unique_ptr<signed_block> b = blog.read_signed_block_by_num( block_num++ ) ) {
+            entry e;
+            e.block = std::move( b );
+            if( thread_pool ) {
+               for( const auto& receipt : e.block->transactions ) {
+                  if( std::holds_alternative<packed_transaction>( receipt.trx ) ) {
+                     const auto& pt = std::get<packed_transaction>( receipt.trx );
+                     packed_transaction_ptr ptrx( e.block, &pt ); // alias signed_block_ptr
+                     e.recovered_trxs.emplace( pt.id(),
+                           transaction_metadata::start_recover_keys( std::move( ptrx ), *thread_pool, chain_id, fc::microseconds::maximum() ) );
+                  }
+               }
+            }
+            std::unique_lock<std::mutex> g( mtx );
+            cv.wait( g, [this]() { return blocks.size() < max_blocks || stopped; } );
+            if( stopped ) break;
+            blocks.emplace_back( std::move( e ) );
+            g.unlock();
+            cv.notify_all();
+         }
+      } catch( ... ) {
+         std::lock_guard<std::mutex> g( mtx );
+         except = std::current_exception();
+      }
+      {
+         std::lock_guard<std::mutex> g( mtx );
+         done = true;
+      }
+      cv.notify_all();
+   }
+
+   const block_log&          blog;
+   const size_t              max_blocks;
+   boost::asio::io_context*  thread_pool;
+   const chain_id_type       chain_id;
+
+   std::mutex                mtx; // protects below
+   std::condition_variable   cv;
+   std::deque<entry>         blocks;
+   bool                      done = false;
+   bool                      stopped = false;
+   std::exception_ptr        except;
+
+   std::thread               reader; // last so all of the above is initialized before it starts
+};
+
 struct controller_impl {
 
    // LLVM sets the new handler, we need to reset this to throw a bad_alloc exception so we can possibly exit cleanly
@@ -429,9 +525,19 @@ struct controller_impl {
          ilog( "existing block log, attempting to replay from ${s} to ${n} blocks",
                ("s", start_block_num)("n", blog_head->block_num()) );
          try {
-            while( std::unique_ptr<signed_block> next = blog.read_signed_block_by_num( head->block_num + 1 ) ) {
-               auto block_num = next->block_num();
-               replay_push_block( std::move(next), controller::block_status::irreversible );
+            constexpr size_t replay_read_ahead_blocks = 256;
+            // keys are only recovered on replay of irreversible blocks if all checks are forced
+            replay_read_ahead read_ahead( blog, start_block_num, replay_read_ahead_blocks,
+                                          conf.force_all_checks ? &thread_pool.get_executor() : nullptr, chain_id );
+            while( std::optional<replay_read_ahead::entry> next = read_ahead.next() ) {
+               auto block_num = next->block->block_num();
+               auto& recovered_trxs = next->recovered_trxs;
+               replay_push_block( next->block, controller::block_status::irreversible,
+                                  [&recovered_trxs]( const transaction_id_type& id ) -> transaction_metadata_ptr {
+                                     auto itr = recovered_trxs.find( id );
+                                     if( itr == recovered_trxs.end() || !itr->second.valid() ) return {};
+                                     return itr->second.get();
+                                  } );
                if( check_shutdown() ) break;
                if( block_num % 500 == 0 ) {
                   ilog( "${n} of ${head}", ("n", block_num)("head", blog_head->block_num()) );
@@ -1249,7 +1355,7 @@ struct controller_impl {
       transaction_trace_ptr trace;
       try {
          auto start = fc::time_point::now();
-         const bool check_auth = !self.skip_auth_check() && !trx->implicit;
+         const bool check_auth = !self.skip_auth_check() && !trx->implicit && !trx->dry_run;
          const fc::microseconds sig_cpu_usage = trx->signature_cpu_usage();
 
          if( !explicit_billed_cpu_time ) {
@@ -1282,6 +1388,14 @@ struct controller_impl {
          };
 
          try {
+            auto phase_start = fc::time_point::now();
+            auto end_phase = [&phase_start]() {
+               auto now = fc::time_point::now();
+               auto phase_time = now - phase_start;
+               phase_start = now;
+               return phase_time;
+            };
+
             const transaction& trn = trx->packed_trx()->get_transaction();
             if( trx->implicit ) {
                EOS_ASSERT( !explicit_net_usage_words, transaction_exception, "NET usage cannot be explicitly set for implicit transactions" );
@@ -1299,6 +1413,7 @@ struct controller_impl {
             }
 
             trx_context.delay = fc::seconds(trn.delay_sec);
+            trace->phase_times.init = end_phase();
 
             if( check_auth ) {
                authorization.check_authorization(
@@ -1310,8 +1425,17 @@ struct controller_impl {
                        false
                );
             }
+            trace->phase_times.auth = end_phase();
             trx_context.exec();
+            trace->phase_times.exec = end_phase();
             trx_context.finalize(); // Automatically rounds up network and CPU usage in trace and bills payers if successful
+            trace->phase_times.finalize = end_phase();
+
+            if( trx->dry_run ) {
+               // not added to the pending block and not signaled, trace is only returned to the caller
+               trx_context.undo();
+               return trace;
+            }
 
             auto restore = make_block_restore_point();
 
@@ -1364,6 +1488,8 @@ struct controller_impl {
            handle_exception(wrapper);
          }
 
+         if( trx->dry_run ) return trace;
+
          emit( self.accepted_transaction, trx );
          emit( self.applied_transaction, std::tie(trace, trx->packed_trx()) );
 
@@ -1905,7 +2031,7 @@ struct controller_impl {
       FC_LOG_AND_RETHROW()
    }
 
-   void replay_push_block( const signed_block_ptr& b, controller::block_status s ) {
+   void replay_push_block( const signed_block_ptr& b, controller::block_status s, const trx_meta_cache_lookup& trx_lookup = {} ) {
       self.validate_db_available_size();
       self.validate_reversible_available_size();
 
@@ -1943,7 +2069,7 @@ struct controller_impl {
          emit( self.accepted_block_header, bsp );
 
          if( s == controller::block_status::irreversible ) {
-            apply_block( bsp, s, trx_meta_cache_lookup{} );
+            apply_block( bsp, s, trx_lookup );
             head = bsp;
 
             // On replay, log_irreversible is not called and so no irreversible_block signal is emitted.
@@ -42,6 +42,8 @@ namespace eosio { namespace chain {
    using session_type = eosio::session::session<rocks_db_type>;
    using kv_undo_stack_ptr = std::unique_ptr<eosio::session::undo_stack<rocks_db_type>>;
 
+   class async_kv_batch_writer;
+
    using controller_index_set =
          index_set<account_index, account_metadata_index, account_ram_correction_index, global_property_multi_index,
                    protocol_state_multi_index, dynamic_global_property_multi_index, block_summary_multi_index,
@@ -136,7 +138,7 @@ namespace eosio { namespace chain {
 
     private:
       void add_contract_tables_to_snapshot(const snapshot_writer_ptr& snapshot) const;
-      void read_contract_tables_from_snapshot(const snapshot_reader_ptr& snapshot);
+      void read_contract_tables_from_snapshot(const snapshot_reader_ptr& snapshot, async_kv_batch_writer* kv_writer);
 
       backing_store_type                                         backing_store;
       chainbase::database&                                       db;
@@ -48,6 +48,15 @@ namespace eosio { namespace chain {
       std::vector<char>               return_value;
    };
 
+   /// wall clock time spent in each phase of transaction_context, not serialized
+   struct transaction_phase_times {
+      fc::microseconds init;
+      fc::microseconds auth;
+      fc::microseconds exec;
+      fc::microseconds finalize;
+      fc::microseconds wasm_instantiation; ///< part of exec, module cache lookups and instantiations, 0 for eos-vm-oc compiled code
+   };
+
    struct transaction_trace {
       transaction_id_type                        id;
       uint32_t                                   block_num = 0;
@@ -64,6 +73,7 @@ namespace eosio { namespace chain {
       std::optional<fc::exception>               except;
       std::optional<uint64_t>                    error_code;
       std::exception_ptr                         except_ptr;
+      transaction_phase_times                    phase_times;
    };
 
    /**
@@ -8,6 +8,11 @@
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
+#include <boost/multi_index/composite_key.hpp>
+
+#include <algorithm>
+#include <map>
+#include <set>
 
 namespace fc {
   inline std::size_t hash_value( const fc::sha256& v ) {
@@ -28,6 +33,13 @@ enum class trx_enum_type {
    incoming = 5 // incoming_end() needs to be updated if this changes
 };
 
+/// how incoming transactions are grouped into lanes that are dequeued fairly with respect to each other
+enum class trx_lane_type {
+   none = 0, // single FIFO lane
+   first_authorizer = 1,
+   contract = 2 // account of the first action
+};
+
 using next_func_t = std::function<void(const std::variant<fc::exception_ptr, transaction_trace_ptr>&)>;
 
 struct unapplied_transaction {
@@ -35,6 +47,7 @@ struct unapplied_transaction {
    const fc::time_point           expiry;
    trx_enum_type                  trx_type = trx_enum_type::unknown;
    next_func_t                    next;
+   account_name                   lane; // only set for incoming
 
    const transaction_id_type& id()const { return trx_meta->id(); }
 
@@ -44,15 +57,27 @@ struct unapplied_transaction {
    unapplied_transaction(unapplied_transaction&&) = default;
 };
 
+struct unapplied_transaction_lane {
+   account_name lane;
+   uint32_t     count = 0;
+   uint64_t     size_in_bytes = 0;
+   uint64_t     dequeued = 0;
+};
+
 /**
  * Track unapplied transactions for persisted, forked blocks, and aborted blocks.
  * Persisted are first so that they can be applied in each block until expired.
+ *
+ * Incoming transactions can optionally be grouped into lanes (e.g. by first authorizer) which are dequeued by
+ * next_incoming() using weighted fair queueing, so a single account cannot starve the others, and which can be
+ * limited in size individually.
  */
 class unapplied_transaction_queue {
 private:
    struct by_trx_id;
    struct by_type;
    struct by_expiry;
+   struct by_lane;
 
    typedef multi_index_container< unapplied_transaction,
       indexed_by<
@@ -60,19 +85,66 @@ private:
                const_mem_fun<unapplied_transaction, const transaction_id_type&, &unapplied_transaction::id>
          >,
          ordered_non_unique< tag<by_type>, member<unapplied_transaction, trx_enum_type, &unapplied_transaction::trx_type> >,
-         ordered_non_unique< tag<by_expiry>, member<unapplied_transaction, const fc::time_point, &unapplied_transaction::expiry> >
+         ordered_non_unique< tag<by_expiry>, member<unapplied_transaction, const fc::time_point, &unapplied_transaction::expiry> >,
+         ordered_non_unique< tag<by_lane>,
+               composite_key< unapplied_transaction,
+                     member<unapplied_transaction, account_name, &unapplied_transaction::lane>,
+                     member<unapplied_transaction, trx_enum_type, &unapplied_transaction::trx_type>
+               >
+         >
       >
    > unapplied_trx_queue_type;
 
+   struct lane_state {
+      uint32_t count = 0;
+      uint64_t size_in_bytes = 0;
+      uint64_t pass = 0; // virtual time of the next dequeue, lowest pass is served first
+      uint64_t dequeued = 0;
+   };
+
+   static constexpr uint64_t lane_stride = 1u << 16; // pass increment of a lane with weight 1
+
    unapplied_trx_queue_type queue;
    uint64_t max_transaction_queue_size = 1024*1024*1024; // enforced for incoming
    uint64_t size_in_bytes = 0;
    size_t incoming_count = 0;
 
+   trx_lane_type                                 lane_type = trx_lane_type::none;
+   uint64_t                                      max_lane_size = 0; // enforced for incoming, 0 for no limit
+   std::map<account_name, uint32_t>              lane_weights; // default weight is 1
+   std::map<account_name, lane_state>            lanes; // only lanes with incoming transactions
+   std::set<std::pair<uint64_t, account_name>>   lane_schedule; // pass, lane
+   uint64_t                                      lane_pass = 0; // pass of the last served lane
+
 public:
 
    void set_max_transaction_queue_size( uint64_t v ) { max_transaction_queue_size = v; }
 
+   /// must be called while there are no incoming transactions
+   void set_lanes( trx_lane_type type, uint64_t max_size, std::map<account_name, uint32_t> weights ) {
+      EOS_ASSERT( incoming_count == 0, misc_exception, "lanes can not be changed with incoming transactions queued" );
+      lane_type = type;
+      max_lane_size = max_size;
+      lane_weights = std::move( weights );
+      for( auto& w : lane_weights ) {
+         w.second = std::min<uint64_t>( std::max<uint32_t>( w.second, 1 ), lane_stride );
+      }
+   }
+
+   trx_lane_type get_lane_type() const { return lane_type; }
+
+   /// lanes with incoming transactions, largest first
+   std::vector<unapplied_transaction_lane> get_lanes( size_t limit ) const {
+      std::vector<unapplied_transaction_lane> result;
+      result.reserve( lanes.size() );
+      for( const auto& l : lanes ) {
+         result.push_back( { l.first, l.second.count, l.second.size_in_bytes, l.second.dequeued } );
+      }
+      std::sort( result.begin(), result.end(), []( const auto& a, const auto& b ) { return a.size_in_bytes > b.size_in_bytes; } );
+      if( result.size() > limit ) result.resize( limit );
+      return result;
+   }
+
    bool empty() const {
       return queue.empty();
    }
@@ -83,6 +155,8 @@ public:
 
    void clear() {
       queue.clear();
+      lanes.clear();
+      lane_schedule.clear();
    }
 
    size_t incoming_size()const {
@@ -174,10 +248,13 @@ public:
          auto insert_itr = queue.insert( { trx, expiry, trx_enum_type::persisted } );
          if( insert_itr.second ) added( insert_itr.first );
       } else if( itr->trx_type != trx_enum_type::persisted ) {
-         if (itr->trx_type == trx_enum_type::incoming || itr->trx_type == trx_enum_type::incoming_persisted)
+         if (itr->trx_type == trx_enum_type::incoming || itr->trx_type == trx_enum_type::incoming_persisted) {
             --incoming_count;
+            lane_removed( itr );
+         }
          queue.get<by_trx_id>().modify( itr, [](auto& un){
             un.trx_type = trx_enum_type::persisted;
+            un.lane = account_name{};
          } );
       }
    }
@@ -185,18 +262,23 @@ public:
    void add_incoming( const transaction_metadata_ptr& trx, bool persist_until_expired, next_func_t next ) {
       auto itr = queue.get<by_trx_id>().find( trx->id() );
       if( itr == queue.get<by_trx_id>().end() ) {
+         const account_name lane = lane_of( trx );
+         check_incoming_size( trx, lane );
          fc::time_point expiry = trx->packed_trx()->expiration();
          auto insert_itr = queue.insert(
-               { trx, expiry, persist_until_expired ? trx_enum_type::incoming_persisted : trx_enum_type::incoming, std::move( next ) } );
+               { trx, expiry, persist_until_expired ? trx_enum_type::incoming_persisted : trx_enum_type::incoming, std::move( next ), lane } );
          if( insert_itr.second ) added( insert_itr.first );
       } else {
-         if (itr->trx_type != trx_enum_type::incoming && itr->trx_type != trx_enum_type::incoming_persisted)
-            ++incoming_count;
-
-         queue.get<by_trx_id>().modify( itr, [persist_until_expired, next{std::move(next)}](auto& un) mutable {
+         const bool was_incoming = itr->trx_type == trx_enum_type::incoming || itr->trx_type == trx_enum_type::incoming_persisted;
+         queue.get<by_trx_id>().modify( itr, [persist_until_expired, next{std::move(next)}, lane{lane_of(trx)}](auto& un) mutable {
             un.trx_type = persist_until_expired ? trx_enum_type::incoming_persisted : trx_enum_type::incoming;
             un.next = std::move( next );
+            un.lane = lane;
          } );
+         if( !was_incoming ) {
+            ++incoming_count;
+            lane_added( itr );
+         }
       }
    }
 
@@ -215,6 +297,24 @@ public:
    iterator incoming_begin() { return queue.get<by_type>().lower_bound( trx_enum_type::incoming_persisted ); }
    iterator incoming_end() { return queue.get<by_type>().end(); } // if changed to upper_bound, verify usage performance
 
+   /// next incoming transaction to process: FIFO without lanes, otherwise the oldest of the lane with the lowest pass,
+   /// whose pass is then advanced inversely proportional to its weight. Returns incoming_end() if none.
+   /// Caller is expected to erase the returned transaction.
+   iterator next_incoming() {
+      if( lane_schedule.empty() ) return incoming_begin();
+      auto sitr = lane_schedule.begin();
+      const account_name lane = sitr->second;
+      lane_pass = sitr->first;
+      lane_schedule.erase( sitr );
+      auto& ls = lanes.at( lane );
+      ls.pass = lane_pass + lane_stride / lane_weight( lane );
+      ++ls.dequeued;
+      lane_schedule.emplace( ls.pass, lane );
+      // incoming_persisted and incoming are the last of trx_enum_type
+      auto itr = queue.get<by_lane>().lower_bound( boost::make_tuple( lane, trx_enum_type::incoming_persisted ) );
+      return queue.project<by_type>( itr );
+   }
+
    /// caller's responsibilty to call next() if applicable
    iterator erase( iterator itr ) {
       removed( itr );
@@ -222,24 +322,80 @@ public:
    }
 
 private:
+   /// checked before insert so that a rejected transaction is not left in the queue
+   void check_incoming_size( const transaction_metadata_ptr& trx, const account_name& lane ) const {
+      auto size = calc_size( trx );
+      EOS_ASSERT( size_in_bytes + size < max_transaction_queue_size, tx_resource_exhaustion,
+                  "Transaction ${id}, size ${s} bytes would exceed configured "
+                  "incoming-transaction-queue-size-mb ${qs}, current queue size ${cs} bytes",
+                  ("id", trx->id())("s", size)("qs", max_transaction_queue_size/(1024*1024))
+                  ("cs", size_in_bytes) );
+      if( max_lane_size > 0 && lane_type != trx_lane_type::none ) {
+         auto litr = lanes.find( lane );
+         uint64_t lane_size = litr != lanes.end() ? litr->second.size_in_bytes : 0;
+         EOS_ASSERT( lane_size + size < max_lane_size, tx_resource_exhaustion,
+                     "Transaction ${id}, size ${s} bytes would exceed configured "
+                     "incoming-transaction-lane-size-mb ${qs} of ${l}, current lane size ${cs} bytes",
+                     ("id", trx->id())("s", size)("qs", max_lane_size/(1024*1024))("l", lane)("cs", lane_size) );
+      }
+   }
+
+   account_name lane_of( const transaction_metadata_ptr& trx ) const {
+      const auto& t = trx->packed_trx()->get_transaction();
+      switch( lane_type ) {
+         case trx_lane_type::first_authorizer:
+            return t.first_authorizer();
+         case trx_lane_type::contract:
+            return t.actions.empty() ? account_name{} : t.actions.front().account;
+         case trx_lane_type::none:
+            break;
+      }
+      return {};
+   }
+
+   uint32_t lane_weight( const account_name& lane ) const {
+      auto itr = lane_weights.find( lane );
+      return itr != lane_weights.end() ? itr->second : 1;
+   }
+
+   template<typename Itr>
+   void lane_added( Itr itr ) {
+      if( lane_type == trx_lane_type::none ) return;
+      auto& ls = lanes[itr->lane];
+      if( ls.count++ == 0 ) {
+         // a new or previously idle lane is served next, it does not accumulate credit while idle
+         ls.pass = std::max( ls.pass, lane_pass );
+         lane_schedule.emplace( ls.pass, itr->lane );
+      }
+      ls.size_in_bytes += calc_size( itr->trx_meta );
+   }
+
+   template<typename Itr>
+   void lane_removed( Itr itr ) {
+      if( lane_type == trx_lane_type::none ) return;
+      auto litr = lanes.find( itr->lane );
+      if( litr == lanes.end() ) return;
+      litr->second.size_in_bytes -= calc_size( itr->trx_meta );
+      if( --litr->second.count == 0 ) {
+         lane_schedule.erase( { litr->second.pass, litr->first } );
+         lanes.erase( litr );
+      }
+   }
+
    template<typename Itr>
    void added( Itr itr ) {
-      auto size = calc_size( itr->trx_meta );
       if( itr->trx_type == trx_enum_type::incoming || itr->trx_type == trx_enum_type::incoming_persisted ) {
          ++incoming_count;
-         EOS_ASSERT( size_in_bytes + size < max_transaction_queue_size, tx_resource_exhaustion,
-                     "Transaction ${id}, size ${s} bytes would exceed configured "
-                     "incoming-transaction-queue-size-mb ${qs}, current queue size ${cs} bytes",
-                     ("id", itr->trx_meta->id())("s", size)("qs", max_transaction_queue_size/(1024*1024))
-                     ("cs", size_in_bytes) );
+         lane_added( itr );
       }
-      size_in_bytes += size;
+      size_in_bytes += calc_size( itr->trx_meta );
    }
 
    template<typename Itr>
    void removed( Itr itr ) {
       if( itr->trx_type == trx_enum_type::incoming || itr->trx_type == trx_enum_type::incoming_persisted ) {
          --incoming_count;
+         lane_removed( itr );
       }
       size_in_bytes -= calc_size( itr->trx_meta );
    }
@@ -251,3 +407,6 @@ private:
 };
 
 } } //eosio::chain
+
+FC_REFLECT_ENUM( eosio::chain::trx_lane_type, (none)(first_authorizer)(contract) )
+FC_REFLECT( eosio::chain::unapplied_transaction_lane, (lane)(count)(size_in_bytes)(dequeued) )
@@ -99,7 +99,10 @@ namespace eosio { namespace chain {
          }
       }
 #endif
-      my->get_instantiated_module(code_hash, vm_type, vm_version, context.trx_context)->apply(context);
+      const auto start = fc::time_point::now();
+      const auto& module = my->get_instantiated_module(code_hash, vm_type, vm_version, context.trx_context);
+      context.trx_context.trace->phase_times.wasm_instantiation += fc::time_point::now() - start;
+      module->apply(context);
    }
 
    void wasm_interface::exit() {
@@ -244,6 +244,7 @@ inline void session<rocksdb_t>::write(const shared_bytes& key, const shared_byte
    auto key_slice   = rocksdb::Slice{ key.data(), key.size() };
    auto value_slice = rocksdb::Slice{ value.data(), value.size() };
    auto status      = m_db->Put(m_write_options, column_family_(), key_slice, value_slice);
+   EOS_ASSERT(status.ok(), eosio::chain::database_exception, "rocksdb write failed: ${s}", ("s", status.ToString()));
 }
 
 inline bool session<rocksdb_t>::contains(const shared_bytes& key) {
@@ -305,6 +306,7 @@ void session<rocksdb_t>::write(const Iterable& key_values) {
    }
 
    auto status = m_db->Write(m_write_options, &batch);
+   EOS_ASSERT(status.ok(), eosio::chain::database_exception, "rocksdb batch write failed: ${s}", ("s", status.ToString()));
 }
 
 template <typename Iterable>
@@ -61,6 +61,24 @@ namespace {
           } \
        }}
 
+// responds with the fc::raw packed form of the result when the client negotiated application/octet-stream
+#define CALL_WITH_400_PACKED(api_name, api_handle, api_namespace, call_name, http_response_code, params_type) \
+{std::string("/v1/" #api_name "/" #call_name), \
+   [api_handle](string, string body, http_content_type accept, url_response_callback cb, url_raw_response_callback raw_cb) mutable { \
+          api_handle.validate(); \
+          try { \
+             auto params = parse_params<api_namespace::call_name ## _params, params_type>(body);\
+             if (accept == http_content_type::octet_stream) { \
+                raw_cb(http_response_code, api_handle.call_name ## _packed( params ), accept); \
+             } else { \
+                fc::variant result( api_handle.call_name( std::move(params) ) ); \
+                cb(http_response_code, std::move(result)); \
+             } \
+          } catch (...) { \
+             http_plugin::handle_exception(#api_name, #call_name, body, cb); \
+          } \
+       }}
+
 #define CALL_ASYNC_WITH_400(api_name, api_handle, api_namespace, call_name, call_result, http_response_code, params_type) \
 {std::string("/v1/" #api_name "/" #call_name), \
    [api_handle](string, string body, url_response_callback cb) mutable { \
@@ -91,6 +109,7 @@ namespace {
 #define CHAIN_RW_CALL_ASYNC(call_name, call_result, http_response_code, params_type) CALL_ASYNC_WITH_400(chain, rw_api, chain_apis::read_write, call_name, call_result, http_response_code, params_type)
 
 #define CHAIN_RO_CALL_WITH_400(call_name, http_response_code, params_type) CALL_WITH_400(chain, ro_api, chain_apis::read_only, call_name, http_response_code, params_type)
+#define CHAIN_RO_CALL_PACKED(call_name, http_response_code, params_type) CALL_WITH_400_PACKED(chain, ro_api, chain_apis::read_only, call_name, http_response_code, params_type)
 
 
    
@@ -108,9 +127,7 @@ void chain_api_plugin::plugin_startup() {
       CHAIN_RO_CALL(get_info, 200, http_params_types::no_params_required)}, appbase::priority::medium_high);
    _http_plugin.add_api({
       CHAIN_RO_CALL(get_activated_protocol_features, 200, http_params_types::possible_no_params),
-      CHAIN_RO_CALL(get_block, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_block_info, 200, http_params_types::params_required),
-      CHAIN_RO_CALL(get_block_header_state, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_account, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_code, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_code_hash, 200, http_params_types::params_required),
@@ -132,9 +149,15 @@ void chain_api_plugin::plugin_startup() {
       CHAIN_RW_CALL_ASYNC(push_block, chain_apis::read_write::push_block_results, 202, http_params_types::params_required),
       CHAIN_RW_CALL_ASYNC(push_transaction, chain_apis::read_write::push_transaction_results, 202, http_params_types::params_required),
       CHAIN_RW_CALL_ASYNC(push_transactions, chain_apis::read_write::push_transactions_results, 202, http_params_types::params_required),
-      CHAIN_RW_CALL_ASYNC(send_transaction, chain_apis::read_write::send_transaction_results, 202, http_params_types::params_required)
+      CHAIN_RW_CALL_ASYNC(send_transaction, chain_apis::read_write::send_transaction_results, 202, http_params_types::params_required),
+      CHAIN_RW_CALL_ASYNC(compute_transaction, chain_apis::read_write::compute_transaction_results, 200, http_params_types::params_required)
    });
    
+   _http_plugin.add_raw_api({
+      CHAIN_RO_CALL_PACKED(get_block, 200, http_params_types::params_required),
+      CHAIN_RO_CALL_PACKED(get_block_header_state, 200, http_params_types::params_required)
+   });
+
    if (chain.account_queries_enabled()) {
       _http_plugin.add_async_api({
          CHAIN_RO_CALL_WITH_400(get_accounts_by_authorizers, 200, http_params_types::params_required),
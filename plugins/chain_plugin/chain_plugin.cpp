@@ -179,6 +179,7 @@ public:
    ,incoming_block_sync_method(app().get_method<incoming::methods::block_sync>())
    ,incoming_blockvault_sync_method(app().get_method<incoming::methods::blockvault_sync>())
    ,incoming_transaction_async_method(app().get_method<incoming::methods::transaction_async>())
+   ,incoming_recovered_transaction_async_method(app().get_method<incoming::methods::recovered_transaction_async>())
    {}
 
    bfs::path                        blocks_dir;
@@ -195,6 +196,7 @@ public:
    //txn_msg_rate_limits              rate_limits;
    std::optional<vm_type>            wasm_runtime;
    fc::microseconds                  abi_serializer_max_time_us;
+   std::shared_ptr<chain_apis::compute_transaction_limits> compute_transaction_limits = std::make_shared<chain_apis::compute_transaction_limits>();
    std::optional<bfs::path>          snapshot_path;
 
 
@@ -211,6 +213,7 @@ public:
    incoming::methods::block_sync::method_type&        incoming_block_sync_method;
    incoming::methods::blockvault_sync::method_type&        incoming_blockvault_sync_method;
    incoming::methods::transaction_async::method_type& incoming_transaction_async_method;
+   incoming::methods::recovered_transaction_async::method_type& incoming_recovered_transaction_async_method;
 
    // method provider handles
    methods::get_block_by_number::method_type::handle                 get_block_by_number_provider;
@@ -311,6 +314,12 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
          )
          ("abi-serializer-max-time-ms", bpo::value<uint32_t>()->default_value(config::default_abi_serializer_max_time_us / 1000),
           "Override default maximum ABI serialization time allowed in ms")
+         ("compute-transaction-time-ms", bpo::value<uint32_t>()->default_value(30),
+          "Maximum time in ms a transaction evaluated by /v1/chain/compute_transaction is allowed to execute. "
+          "Dry runs execute on the main thread and delay block and transaction processing by up to this time each.")
+         ("compute-transaction-max-queued", bpo::value<uint32_t>()->default_value(8),
+          "Maximum number of /v1/chain/compute_transaction requests waiting for the main thread, further requests are rejected. "
+          "Requests are also rejected while this node is producing a block. 0 disables compute_transaction.")
          ("chain-state-db-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_size / (1024  * 1024)), "Maximum size (in MiB) of the chain state database")
          ("chain-state-db-guard-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_guard_size / (1024  * 1024)), "Safely shut down node when free space remaining in the chain state database drops below this size (in MiB).")
          ("backing-store", boost::program_options::value<eosio::chain::backing_store_type>()->default_value(eosio::chain::backing_store_type::CHAINBASE),
@@ -815,6 +824,9 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
          my->chain_config->abi_serializer_max_time_us = my->abi_serializer_max_time_us;
       }
 
+      my->compute_transaction_limits->max_time = fc::milliseconds( options.at( "compute-transaction-time-ms" ).as<uint32_t>() );
+      my->compute_transaction_limits->max_queued = options.at( "compute-transaction-max-queued" ).as<uint32_t>();
+
       my->chain_config->blog.log_dir                 = my->blocks_dir;
       my->chain_config->state_dir                    = app().data_dir() / config::default_state_dir_name;
       my->chain_config->read_only                    = my->readonly;
@@ -1394,9 +1406,11 @@ void chain_plugin::handle_sighup() {
    fc::logger::update( deep_mind_logger_name, _deep_mind_log );
 }
 
-chain_apis::read_write::read_write(controller& db, const fc::microseconds& abi_serializer_max_time, bool api_accept_transactions)
+chain_apis::read_write::read_write(controller& db, const fc::microseconds& abi_serializer_max_time,
+                                   std::shared_ptr<compute_transaction_limits> compute_limits, bool api_accept_transactions)
 : db(db)
 , abi_serializer_max_time(abi_serializer_max_time)
+, compute_limits(std::move(compute_limits))
 , api_accept_transactions(api_accept_transactions)
 {
 }
@@ -1419,6 +1433,10 @@ void chain_plugin::accept_transaction(const chain::packed_transaction_ptr& trx,
    my->incoming_transaction_async_method(trx, false, std::move(next));
 }
 
+void chain_plugin::accept_transaction(const chain::transaction_metadata_ptr& trx, next_function<chain::transaction_trace_ptr> next) {
+   my->incoming_recovered_transaction_async_method(trx, false, std::move(next));
+}
+
 bool chain_plugin::recover_reversible_blocks( const fc::path& db_dir, uint32_t cache_size,
                                               std::optional<fc::path> new_db_dir, uint32_t truncate_at_block ) {
    try {
@@ -1641,6 +1659,10 @@ fc::microseconds chain_plugin::get_abi_serializer_max_time() const {
    return my->abi_serializer_max_time_us;
 }
 
+std::shared_ptr<chain_apis::compute_transaction_limits> chain_plugin::get_compute_transaction_limits() const {
+   return my->compute_transaction_limits;
+}
+
 bool chain_plugin::api_accept_transactions() const{
    return my->api_accept_transactions;
 }
@@ -2901,28 +2923,34 @@ read_only::get_scheduled_transactions( const read_only::get_scheduled_transactio
    return result;
 }
 
-fc::variant read_only::get_block(const read_only::get_block_params& params) const {
+signed_block_ptr read_only::fetch_block(const string& block_num_or_id) const {
    signed_block_ptr block;
    std::optional<uint64_t> block_num;
 
-   EOS_ASSERT( !params.block_num_or_id.empty() && params.block_num_or_id.size() <= 64,
+   EOS_ASSERT( !block_num_or_id.empty() && block_num_or_id.size() <= 64,
                chain::block_id_type_exception,
                "Invalid Block number or ID, must be greater than 0 and less than 64 characters"
    );
 
    try {
-      block_num = fc::to_uint64(params.block_num_or_id);
+      block_num = fc::to_uint64(block_num_or_id);
    } catch( ... ) {}
 
    if( block_num ) {
       block = db.fetch_block_by_number( *block_num );
    } else {
       try {
-         block = db.fetch_block_by_id( fc::variant(params.block_num_or_id).as<block_id_type>() );
-      } EOS_RETHROW_EXCEPTIONS(chain::block_id_type_exception, "Invalid block ID: ${block_num_or_id}", ("block_num_or_id", params.block_num_or_id))
+         block = db.fetch_block_by_id( fc::variant(block_num_or_id).as<block_id_type>() );
+      } EOS_RETHROW_EXCEPTIONS(chain::block_id_type_exception, "Invalid block ID: ${block_num_or_id}", ("block_num_or_id", block_num_or_id))
    }
 
-   EOS_ASSERT( block, unknown_block_exception, "Could not find block: ${block}", ("block", params.block_num_or_id));
+   EOS_ASSERT( block, unknown_block_exception, "Could not find block: ${block}", ("block", block_num_or_id));
+
+   return block;
+}
+
+fc::variant read_only::get_block(const read_only::get_block_params& params) const {
+   signed_block_ptr block = fetch_block( params.block_num_or_id );
 
    // serializes signed_block to variant in signed_block_v0 format
    fc::variant pretty_output;
@@ -2938,6 +2966,15 @@ fc::variant read_only::get_block(const read_only::get_block_params& params) cons
            ("ref_block_prefix", ref_block_prefix);
 }
 
+std::string read_only::get_block_packed(const read_only::get_block_params& params) const {
+   signed_block_ptr block = fetch_block( params.block_num_or_id );
+
+   std::string result( fc::raw::pack_size( *block ), '\0' );
+   fc::datastream<char*> ds( result.data(), result.size() );
+   fc::raw::pack( ds, *block );
+   return result;
+}
+
 fc::variant read_only::get_block_info(const read_only::get_block_info_params& params) const {
 
    signed_block_ptr block;
@@ -2967,29 +3004,44 @@ fc::variant read_only::get_block_info(const read_only::get_block_info_params& pa
          ("ref_block_prefix", ref_block_prefix);
 }
 
-fc::variant read_only::get_block_header_state(const get_block_header_state_params& params) const {
+block_state_ptr read_only::fetch_block_header_state(const string& block_num_or_id) const {
    block_state_ptr b;
    std::optional<uint64_t> block_num;
-   std::exception_ptr e;
    try {
-      block_num = fc::to_uint64(params.block_num_or_id);
+      block_num = fc::to_uint64(block_num_or_id);
    } catch( ... ) {}
 
    if( block_num ) {
       b = db.fetch_block_state_by_number(*block_num);
    } else {
       try {
-         b = db.fetch_block_state_by_id(fc::variant(params.block_num_or_id).as<block_id_type>());
-      } EOS_RETHROW_EXCEPTIONS(chain::block_id_type_exception, "Invalid block ID: ${block_num_or_id}", ("block_num_or_id", params.block_num_or_id))
+         b = db.fetch_block_state_by_id(fc::variant(block_num_or_id).as<block_id_type>());
+      } EOS_RETHROW_EXCEPTIONS(chain::block_id_type_exception, "Invalid block ID: ${block_num_or_id}", ("block_num_or_id", block_num_or_id))
    }
 
-   EOS_ASSERT( b, unknown_block_exception, "Could not find reversible block: ${block}", ("block", params.block_num_or_id));
+   EOS_ASSERT( b, unknown_block_exception, "Could not find reversible block: ${block}", ("block", block_num_or_id));
+
+   return b;
+}
+
+fc::variant read_only::get_block_header_state(const get_block_header_state_params& params) const {
+   block_state_ptr b = fetch_block_header_state( params.block_num_or_id );
 
    fc::variant vo;
    fc::to_variant( static_cast<const block_header_state&>(*b), vo );
    return vo;
 }
 
+std::string read_only::get_block_header_state_packed(const get_block_header_state_params& params) const {
+   block_state_ptr b = fetch_block_header_state( params.block_num_or_id );
+   const auto& bhs = static_cast<const block_header_state&>(*b);
+
+   std::string result( fc::raw::pack_size( bhs ), '\0' );
+   fc::datastream<char*> ds( result.data(), result.size() );
+   fc::raw::pack( ds, bhs );
+   return result;
+}
+
 void read_write::push_block(read_write::push_block_params&& params, next_function<read_write::push_block_results> next) {
    try {
       app().get_method<incoming::methods::block_sync>()(std::make_shared<signed_block>( std::move( params ), true), {});
@@ -3202,6 +3254,60 @@ void read_write::send_transaction(const read_write::send_transaction_params& par
    } CATCH_AND_CALL(next);
 }
 
+void read_write::compute_transaction(const read_write::compute_transaction_params& params, next_function<read_write::compute_transaction_results> next) {
+
+   try {
+      packed_transaction_v0 input_trx_v0;
+      auto resolver = make_resolver(this, abi_serializer::create_yield_function( abi_serializer_max_time ));
+      packed_transaction_ptr input_trx;
+      try {
+         abi_serializer::from_variant(params, input_trx_v0, std::move( resolver ), abi_serializer::create_yield_function( abi_serializer_max_time ));
+         input_trx = std::make_shared<packed_transaction>( std::move( input_trx_v0 ), true );
+      } EOS_RETHROW_EXCEPTIONS(chain::packed_transaction_type_exception, "Invalid packed transaction")
+
+      // signatures are not required, authorization is not checked
+      auto trx_meta = transaction_metadata::create_no_recover_keys( input_trx, transaction_metadata::trx_type::dry_run );
+
+      // each dry run holds the main thread for up to max_time, bound how many can be waiting for it
+      if( compute_limits->queued.fetch_add( 1 ) >= compute_limits->max_queued ) {
+         --compute_limits->queued;
+         EOS_THROW( tx_resource_exhaustion, "compute_transaction rejected, ${n} requests already queued",
+                    ("n", compute_limits->max_queued) );
+      }
+
+      // does not go through the producer_plugin incoming queue, low priority so blocks and transactions are not delayed
+      app().post( priority::low, [this, trx_meta, next]() {
+         --compute_limits->queued;
+         try {
+            EOS_ASSERT( db.is_building_block(), missing_pending_block_state,
+                        "compute_transaction requires a pending block, not available in irreversible or read-only read-mode" );
+            // do not take time away from the block being produced
+            EOS_ASSERT( !db.is_producing_block(), producer_exception, "compute_transaction rejected, producing a block" );
+            auto trx_trace_ptr = db.push_transaction( trx_meta, fc::time_point::now() + compute_limits->max_time, 0, false, 0 );
+
+            fc::variant output;
+            try {
+               output = db.to_variant_with_abi( *trx_trace_ptr, abi_serializer::create_yield_function( abi_serializer_max_time ) );
+            } catch( chain::abi_exception& ) {
+               output = *trx_trace_ptr;
+            }
+
+            next(read_write::compute_transaction_results{trx_trace_ptr->id, output});
+         } catch ( const guard_exception& e ) {
+            chain_plugin::handle_guard_exception(e);
+         } catch ( boost::interprocess::bad_alloc& ) {
+            chain_plugin::handle_db_exhaustion();
+         } catch ( const std::bad_alloc& ) {
+            chain_plugin::handle_bad_alloc();
+         } CATCH_AND_CALL(next);
+      });
+   } catch ( boost::interprocess::bad_alloc& ) {
+      chain_plugin::handle_db_exhaustion();
+   } catch ( const std::bad_alloc& ) {
+      chain_plugin::handle_bad_alloc();
+   } CATCH_AND_CALL(next);
+}
+
 read_only::get_abi_results read_only::get_abi( const get_abi_params& params )const {
    get_abi_results result;
    result.account_name = params.account_name;
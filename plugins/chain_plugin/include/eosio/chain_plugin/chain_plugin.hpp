@@ -20,6 +20,7 @@
 #include <eosio/to_key.hpp>
 
 #include <boost/container/flat_set.hpp>
+#include <atomic>
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include <eosio/chain_plugin/account_query_db.hpp>
@@ -104,6 +105,9 @@ class read_only {
    const fc::microseconds abi_serializer_max_time;
    bool  shorten_abi_errors = true;
 
+   chain::signed_block_ptr fetch_block(const string& block_num_or_id) const;
+   chain::block_state_ptr fetch_block_header_state(const string& block_num_or_id) const;
+
 public:
    static const string KEYi64;
 
@@ -319,6 +323,9 @@ public:
 
    fc::variant get_block(const get_block_params& params) const;
 
+   // fc::raw packed signed_block, skips the ABI-to-variant conversion of get_block entirely
+   std::string get_block_packed(const get_block_params& params) const;
+
    struct get_block_info_params {
       uint32_t block_num;
    };
@@ -331,6 +338,9 @@ public:
 
    fc::variant get_block_header_state(const get_block_header_state_params& params) const;
 
+   // fc::raw packed block_header_state
+   std::string get_block_header_state_packed(const get_block_header_state_params& params) const;
+
    struct get_table_rows_params {
       bool                 json = false;
       name                 code;
@@ -913,12 +923,21 @@ public:
    friend struct resolver_factory<read_only>;
 };
 
+/// limits of read_write::compute_transaction, shared by all read_write instances
+struct compute_transaction_limits {
+   fc::microseconds        max_time;
+   uint32_t                max_queued = 0;
+   std::atomic<uint32_t>   queued{0}; ///< dry runs posted to the application thread and not yet executed
+};
+
 class read_write {
    controller& db;
    const fc::microseconds abi_serializer_max_time;
+   const std::shared_ptr<compute_transaction_limits> compute_limits;
    const bool api_accept_transactions;
 public:
-   read_write(controller& db, const fc::microseconds& abi_serializer_max_time, bool api_accept_transactions);
+   read_write(controller& db, const fc::microseconds& abi_serializer_max_time,
+              std::shared_ptr<compute_transaction_limits> compute_limits, bool api_accept_transactions);
    void validate() const;
 
    using push_block_params = chain::signed_block_v0;
@@ -941,6 +960,13 @@ public:
    using send_transaction_results = push_transaction_results;
    void send_transaction(const send_transaction_params& params, chain::plugin_interface::next_function<send_transaction_results> next);
 
+   /// Executes the transaction against the pending block state and always rolls it back. Signatures and
+   /// authorization are not checked. Useful for dry-runs and for retrieving action return values.
+   /// Runs on the application thread, rejected while producing or when too many dry runs are queued.
+   using compute_transaction_params = push_transaction_params;
+   using compute_transaction_results = push_transaction_results;
+   void compute_transaction(const compute_transaction_params& params, chain::plugin_interface::next_function<compute_transaction_results> next);
+
    friend resolver_factory<read_write>;
 };
 
@@ -1029,11 +1055,15 @@ public:
    void plugin_shutdown();
    void handle_sighup() override;
 
-   chain_apis::read_write get_read_write_api() { return chain_apis::read_write(chain(), get_abi_serializer_max_time(), api_accept_transactions()); }
+   chain_apis::read_write get_read_write_api() {
+      return chain_apis::read_write(chain(), get_abi_serializer_max_time(), get_compute_transaction_limits(), api_accept_transactions());
+   }
    chain_apis::read_only get_read_only_api() const;
    
    bool accept_block( const chain::signed_block_ptr& block, const chain::block_id_type& id );
    void accept_transaction(const chain::packed_transaction_ptr& trx, chain::plugin_interface::next_function<chain::transaction_trace_ptr> next);
+   /// trx keys already recovered, call from main thread
+   void accept_transaction(const chain::transaction_metadata_ptr& trx, chain::plugin_interface::next_function<chain::transaction_trace_ptr> next);
 
    static bool recover_reversible_blocks( const fc::path& db_dir,
                                           uint32_t cache_size,
@@ -1057,6 +1087,7 @@ public:
 
    chain::chain_id_type get_chain_id() const;
    fc::microseconds get_abi_serializer_max_time() const;
+   std::shared_ptr<chain_apis::compute_transaction_limits> get_compute_transaction_limits() const;
    bool api_accept_transactions() const;
    // set true by other plugins if any plugin allows transactions
    bool accept_transactions() const;
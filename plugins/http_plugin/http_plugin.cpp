@@ -14,6 +14,7 @@
 
 #include <boost/asio.hpp>
 #include <boost/optional.hpp>
+#include <boost/algorithm/string.hpp>
 
 #include <websocketpp/config/asio_client.hpp>
 #include <websocketpp/config/asio.hpp>
@@ -22,6 +23,7 @@
 #include <websocketpp/client.hpp>
 #include <websocketpp/logger/stub.hpp>
 
+#include <algorithm>
 #include <thread>
 #include <memory>
 #include <regex>
@@ -136,6 +138,7 @@ namespace eosio {
          virtual bool verify_max_requests_in_flight() = 0;
          virtual void handle_exception() = 0;
 
+         virtual void set_content_type(http_content_type content_type) = 0;
          virtual void send_response(std::optional<std::string> body, int code) = 0;
       };
 
@@ -147,7 +150,75 @@ namespace eosio {
       /**
        * internal url handler that contains more parameters than the handlers provided by external systems
        */
-      using internal_url_handler = std::function<void(abstract_conn_ptr, string, string, url_response_callback)>;
+      using internal_url_handler = std::function<void(abstract_conn_ptr, string, string, http_content_type, url_response_callback, url_raw_response_callback)>;
+
+      /**
+       * Quality value of the most specific media range of an Accept header that matches type/subtype, -1 if
+       * none matches.  Types are compared case-insensitively, parameters other than q do not affect the match.
+       * @param exact - only match the type/subtype media range itself, not the wildcard media ranges
+       */
+      static double accept_quality( const std::string& accept, const std::string& type, const std::string& subtype, bool exact ) {
+         double quality = -1;
+         int best_specificity = -1;
+         std::vector<std::string> ranges;
+         boost::split( ranges, accept, boost::is_any_of( "," ) );
+         for( const auto& range : ranges ) {
+            std::vector<std::string> params;
+            boost::split( params, range, boost::is_any_of( ";" ) );
+            const std::string media = boost::trim_copy( params.front() );
+            const auto slash = media.find( '/' );
+            if( slash == std::string::npos ) continue;
+            const std::string range_type = boost::trim_copy( media.substr( 0, slash ) );
+            const std::string range_subtype = boost::trim_copy( media.substr( slash + 1 ) );
+
+            int specificity = -1;
+            if( boost::iequals( range_type, type ) && boost::iequals( range_subtype, subtype ) ) {
+               specificity = 2;
+            } else if( !exact && boost::iequals( range_type, type ) && range_subtype == "*" ) {
+               specificity = 1;
+            } else if( !exact && range_type == "*" && range_subtype == "*" ) {
+               specificity = 0;
+            }
+            if( specificity <= best_specificity ) continue;
+
+            // parameters after q are accept extensions, a malformed q is treated as not acceptable
+            double q = 1;
+            for( size_t i = 1; i < params.size(); ++i ) {
+               const auto eq = params[i].find( '=' );
+               if( eq == std::string::npos || !boost::iequals( boost::trim_copy( params[i].substr( 0, eq ) ), "q" ) ) continue;
+               try {
+                  q = std::clamp( std::stod( boost::trim_copy( params[i].substr( eq + 1 ) ) ), 0.0, 1.0 );
+               } catch( ... ) {
+                  q = 0;
+               }
+               break;
+            }
+            best_specificity = specificity;
+            quality = q;
+         }
+         return quality;
+      }
+
+      /**
+       * Pick the response content type for a request based on its Accept header.  Only an explicit
+       * application/octet-stream media range with a non-zero quality, not lower than the quality of JSON,
+       * selects the binary format, everything else gets JSON.
+       */
+      static http_content_type negotiate_content_type( const std::string& accept ) {
+         const double octet_stream_q = accept_quality( accept, "application", "octet-stream", true );
+         if( octet_stream_q > 0 && octet_stream_q >= accept_quality( accept, "application", "json", false ) ) {
+            return http_content_type::octet_stream;
+         }
+         return http_content_type::json;
+      }
+
+      static const char* to_mime_type( http_content_type content_type ) {
+         switch( content_type ) {
+            case http_content_type::octet_stream: return "application/octet-stream";
+            case http_content_type::json:
+            default:                              return "application/json";
+         }
+      }
 
       /**
        * Helper method to calculate the "in flight" size of a string
@@ -429,6 +500,10 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
                http_plugin_impl::handle_exception<T>(_conn);
             }
 
+            void set_content_type(http_content_type content_type) override {
+               _conn->replace_header( "Content-type", detail::to_mime_type( content_type ) );
+            }
+
             void send_response(std::optional<std::string> body, int code) override {
                if( body ) {
                   _conn->set_body( std::move( *body ) );
@@ -536,7 +611,7 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
          static detail::internal_url_handler make_app_thread_url_handler( int priority, url_handler next, http_plugin_impl_ptr my ) {
             auto next_ptr = std::make_shared<url_handler>(std::move(next));
             return [my=std::move(my), priority, next_ptr=std::move(next_ptr)]
-                       ( detail::abstract_conn_ptr conn, string r, string b, url_response_callback then ) {
+                       ( detail::abstract_conn_ptr conn, string r, string b, http_content_type, url_response_callback then, url_raw_response_callback ) {
                auto tracked_b = make_in_flight<string>(std::move(b), my);
                if (!conn->verify_max_bytes_in_flight()) {
                   return;
@@ -559,6 +634,43 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
             };
          }
 
+         /**
+          * Make an internal_url_handler that will run the url_raw_handler on the app() thread and then
+          * return to the http thread pool for response processing
+          *
+          * @pre b.size() has been added to bytes_in_flight by caller
+          * @param priority - priority to post to the app thread at
+          * @param next - the next handler for responses
+          * @param my - the http_plugin_impl
+          * @return the constructed internal_url_handler
+          */
+         static detail::internal_url_handler make_app_thread_url_raw_handler( int priority, url_raw_handler next, http_plugin_impl_ptr my ) {
+            auto next_ptr = std::make_shared<url_raw_handler>(std::move(next));
+            return [my=std::move(my), priority, next_ptr=std::move(next_ptr)]
+                       ( detail::abstract_conn_ptr conn, string r, string b, http_content_type accept, url_response_callback then, url_raw_response_callback raw_then ) {
+               auto tracked_b = make_in_flight<string>(std::move(b), my);
+               if (!conn->verify_max_bytes_in_flight()) {
+                  return;
+               }
+
+               url_response_callback wrapped_then = [tracked_b, then=std::move(then)](int code, std::optional<fc::variant> resp) {
+                  then(code, std::move(resp));
+               };
+               url_raw_response_callback wrapped_raw_then = [tracked_b, raw_then=std::move(raw_then)](int code, std::string resp, http_content_type content_type) {
+                  raw_then(code, std::move(resp), content_type);
+               };
+
+               app().post( priority, [next_ptr, conn=std::move(conn), r=std::move(r), tracked_b, accept,
+                                      wrapped_then=std::move(wrapped_then), wrapped_raw_then=std::move(wrapped_raw_then)]() mutable {
+                  try {
+                     (*next_ptr)( std::move( r ), std::move(tracked_b->obj()), accept, std::move(wrapped_then), std::move(wrapped_raw_then) );
+                  } catch( ... ) {
+                     conn->handle_exception();
+                  }
+               } );
+            };
+         }
+
          /**
           * Make an internal_url_handler that will run the url_handler directly
           *
@@ -567,7 +679,7 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
           * @return the constructed internal_url_handler
           */
          static detail::internal_url_handler make_http_thread_url_handler(url_handler next) {
-            return [next=std::move(next)]( const detail::abstract_conn_ptr& conn, string r, string b, url_response_callback then ) {
+            return [next=std::move(next)]( const detail::abstract_conn_ptr& conn, string r, string b, http_content_type, url_response_callback then, url_raw_response_callback ) {
                try {
                   next(std::move(r), std::move(b), std::move(then));
                } catch( ... ) {
@@ -576,6 +688,23 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
              };
          }
 
+         /**
+          * Make an internal_url_handler that will run the url_raw_handler directly
+          *
+          * @pre b.size() has been added to bytes_in_flight by caller
+          * @param next - the next handler for responses
+          * @return the constructed internal_url_handler
+          */
+         static detail::internal_url_handler make_http_thread_url_raw_handler(url_raw_handler next) {
+            return [next=std::move(next)]( const detail::abstract_conn_ptr& conn, string r, string b, http_content_type accept, url_response_callback then, url_raw_response_callback raw_then ) {
+               try {
+                  next(std::move(r), std::move(b), accept, std::move(then), std::move(raw_then));
+               } catch( ... ) {
+                  conn->handle_exception();
+               }
+             };
+         }
+
          /**
           * Construct a lambda appropriate for url_response_callback that will
           * JSON-stringify the provided response
@@ -609,6 +738,33 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
             };
          }
 
+         /**
+          * Construct a lambda appropriate for url_raw_response_callback that will
+          * send the provided, already serialized, response with its content type
+          *
+          * @param con - pointer for the connection this response should be sent to
+          * @return lambda suitable for url_raw_response_callback
+          */
+         auto make_http_raw_response_handler( const detail::abstract_conn_ptr& abstract_conn_ptr) {
+            return [my=shared_from_this(), abstract_conn_ptr]( int code, std::string response, http_content_type content_type ) {
+               auto tracked_response = make_in_flight(std::move(response), my);
+               if (!abstract_conn_ptr->verify_max_bytes_in_flight()) {
+                  return;
+               }
+
+               // post  back to an HTTP thread to to allow the response handler to be called from any thread
+               boost::asio::post( my->thread_pool->get_executor(),
+                                  [abstract_conn_ptr, code, content_type, tracked_response=std::move(tracked_response)]() {
+                  try {
+                     abstract_conn_ptr->set_content_type( content_type );
+                     abstract_conn_ptr->send_response( std::move( tracked_response->obj() ), code );
+                  } catch( ... ) {
+                     abstract_conn_ptr->handle_exception();
+                  }
+               });
+            };
+         }
+
          template<class T>
          void handle_http_request(detail::connection_ptr<T> con) {
             try {
@@ -645,7 +801,9 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
                auto handler_itr = url_handlers.find( resource );
                if( handler_itr != url_handlers.end()) {
                   std::string body = con->get_request_body();
-                  handler_itr->second( abstract_conn_ptr, std::move( resource ), std::move( body ), make_http_response_handler<T>(abstract_conn_ptr) );
+                  const auto accept = detail::negotiate_content_type( req.get_header( "Accept" ) );
+                  handler_itr->second( abstract_conn_ptr, std::move( resource ), std::move( body ), accept,
+                                       make_http_response_handler<T>(abstract_conn_ptr), make_http_raw_response_handler(abstract_conn_ptr) );
                } else {
                   fc_dlog( logger, "404 - not found: ${ep}", ("ep", resource) );
                   error_results results{websocketpp::http::status_code::not_found,
@@ -989,6 +1147,16 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
       my->url_handlers[url] = my->make_http_thread_url_handler(handler);
    }
 
+   void http_plugin::add_raw_handler(const string& url, const url_raw_handler& handler, int priority) {
+      fc_ilog( logger, "add api url: ${c}", ("c", url) );
+      my->url_handlers[url] = my->make_app_thread_url_raw_handler(priority, handler, my);
+   }
+
+   void http_plugin::add_async_raw_handler(const string& url, const url_raw_handler& handler) {
+      fc_ilog( logger, "add api url: ${c}", ("c", url) );
+      my->url_handlers[url] = my->make_http_thread_url_raw_handler(handler);
+   }
+
    void http_plugin::handle_exception( const char *api_name, const char *call_name, const string& body, url_response_callback cb ) {
       try {
          try {
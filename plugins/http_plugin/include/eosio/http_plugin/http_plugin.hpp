@@ -28,6 +28,36 @@ namespace eosio {
     **/
    using url_handler = std::function<void(string,string,url_response_callback)>;
 
+   /**
+    * @brief Content types which a raw URL handler may respond with
+    *
+    * octet_stream is only negotiated when the request's Accept header lists application/octet-stream
+    * with a non-zero quality that is not lower than the quality it gives JSON
+    */
+   enum class http_content_type {
+      json,
+      octet_stream
+   };
+
+   /**
+    * @brief A callback function provided to a raw URL handler to
+    * allow it to specify the HTTP response code and an already
+    * serialized response body of the given content type
+    *
+    * Arguments: response_code, response_body, content_type
+    */
+   using url_raw_response_callback = std::function<void(int,std::string,http_content_type)>;
+
+   /**
+    * @brief Callback type for a URL handler that serializes its own response
+    *
+    * The handler must gaurantee that exactly one of the callbacks is called;
+    * the url_response_callback is intended for (JSON) error responses.
+    *
+    * Arguments: url, request_body, accepted_content_type, response_callback, raw_response_callback
+    **/
+   using url_raw_handler = std::function<void(string,string,http_content_type,url_response_callback,url_raw_response_callback)>;
+
    /**
     * @brief An API, containing URLs and handlers
     *
@@ -37,6 +67,11 @@ namespace eosio {
     */
    using api_description = std::map<string, url_handler>;
 
+   /**
+    * @brief An API whose handlers serialize their own responses
+    */
+   using raw_api_description = std::map<string, url_raw_handler>;
+
    struct http_plugin_defaults {
       //If empty, unix socket support will be completely disabled. If not empty,
       // unix socket support is enabled with the given default path (treated relative
@@ -90,6 +125,16 @@ namespace eosio {
               add_handler(call.first, call.second);
         }
 
+        /// add a handler, run on the app thread, which responds with an already serialized body
+        void add_raw_handler(const string& url, const url_raw_handler& handler, int priority = appbase::priority::medium_low);
+        void add_raw_api(const raw_api_description& api, int priority = appbase::priority::medium_low) {
+           for (const auto& call : api)
+              add_raw_handler(call.first, call.second, priority);
+        }
+
+        /// add a handler, run on the http thread pool, which responds with an already serialized body
+        void add_async_raw_handler(const string& url, const url_raw_handler& handler);
+
         // standard exception handling for api handlers
         static void handle_exception( const char *api_name, const char *call_name, const string& body, url_response_callback cb );
 
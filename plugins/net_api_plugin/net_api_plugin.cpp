@@ -66,6 +66,8 @@ void net_api_plugin::plugin_startup() {
             INVOKE_R_R(net_mgr, status, std::string), 201),
        CALL_WITH_400(net, net_mgr, connections,
             INVOKE_R_V(net_mgr, connections), 201),
+       CALL_WITH_400(net, net_mgr, metrics,
+            INVOKE_R_V(net_mgr, metrics), 201),
     //   CALL(net, net_mgr, open,
     //        INVOKE_V_R(net_mgr, open, std::string), 200),
    }, appbase::priority::medium_high);
@@ -13,6 +13,27 @@ namespace eosio {
       handshake_message last_handshake;
    };
 
+   /// traffic with a single peer since the connection was last (re)established
+   struct connection_metrics {
+      string              peer;
+      uint32_t            connection_id = 0;
+      fc::time_point      since;
+      uint64_t            bytes_received = 0;
+      uint64_t            bytes_sent = 0;
+      uint32_t            write_queue_bytes = 0;
+      fc::variant_object  messages_received;            ///< count by message type
+      uint64_t            message_processing_us = 0;    ///< time spent unpacking and handling messages on the connection strand
+      uint64_t            trxs_received = 0;
+      uint64_t            duplicate_trxs_received = 0;
+      uint64_t            blocks_received = 0;
+      uint64_t            duplicate_blocks_received = 0;
+      vector<uint32_t>    block_latency_bounds_ms;      ///< upper bound of each histogram bucket but the last
+      vector<uint64_t>    block_latency_histogram;      ///< blocks received while in sync by now - block timestamp
+      int64_t             rtt_us = 0;                   ///< smoothed round trip time, 0 until measured
+      int64_t             sync_block_interval_us = 0;   ///< smoothed time between sync blocks, 0 until measured
+      uint32_t            sync_failures = 0;            ///< recent rejected blocks and sync timeouts
+   };
+
    class net_plugin : public appbase::plugin<net_plugin>
    {
       public:
@@ -31,6 +52,7 @@ namespace eosio {
         string                            disconnect( const string& endpoint );
         std::optional<connection_status>  status( const string& endpoint )const;
         vector<connection_status>         connections()const;
+        vector<connection_metrics>        metrics()const;
 
       private:
         std::shared_ptr<class net_plugin_impl> my;
@@ -39,3 +61,7 @@ namespace eosio {
 }
 
 FC_REFLECT( eosio::connection_status, (peer)(connecting)(syncing)(last_handshake) )
+FC_REFLECT( eosio::connection_metrics, (peer)(connection_id)(since)(bytes_received)(bytes_sent)(write_queue_bytes)
+            (messages_received)(message_processing_us)(trxs_received)(duplicate_trxs_received)
+            (blocks_received)(duplicate_blocks_received)(block_latency_bounds_ms)(block_latency_histogram)
+            (rtt_us)(sync_block_interval_us)(sync_failures) )
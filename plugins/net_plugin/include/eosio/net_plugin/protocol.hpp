@@ -140,6 +140,47 @@ namespace eosio {
       std::shared_ptr<packed_transaction> trx;
    };
 
+   /// 64 bits of a transaction id, enough to identify a transaction a peer has most likely already received
+   using short_trx_id_type = uint64_t;
+
+   inline short_trx_id_type short_trx_id( const transaction_id_type& id ) { return id._hash[1]; }
+
+   struct compact_trx_receipt : public transaction_receipt_header {
+      /// short id of a packed_transaction receipt, or the full id of an id only receipt
+      std::variant<short_trx_id_type, transaction_id_type> trx;
+   };
+
+   /// signed_block with packed_transactions replaced by short ids, only sent to peers >= proto_compact_blocks
+   struct compact_block_message {
+      signed_block_header                                       header;
+      fc::enum_type<uint8_t,signed_block::prune_state_type>     prune_state{signed_block::prune_state_type::complete_legacy};
+      vector<compact_trx_receipt>                               transactions;
+      extensions_type                                           block_extensions;
+   };
+
+   /// request for the transactions of a compact_block_message the peer could not find locally
+   struct request_compact_trxs_message {
+      block_id_type                  id;
+      vector<uint32_t>               indexes; ///< indexes into compact_block_message::transactions
+   };
+
+   struct compact_trxs_message {
+      block_id_type                  id;
+      vector<packed_transaction>     trxs; ///< in the order of request_compact_trxs_message::indexes
+   };
+
+   /// sent after the handshake to peers >= proto_sync_compression, tells the peer whether to use compressed_block_message during sync
+   struct sync_compression_message {
+      bool                           accept_compressed_blocks = false;
+   };
+
+   /// zlib compressed signed_block, only sent during sync to peers that have accepted it with sync_compression_message
+   struct compressed_block_message {
+      block_header                   header; ///< uncompressed copy so known blocks are dropped without decompressing
+      uint32_t                       uncompressed_size = 0;
+      bytes                          data;
+   };
+
    using net_message = std::variant<handshake_message,
                                     chain_size_message,
                                     go_away_message,
@@ -150,7 +191,12 @@ namespace eosio {
                                     signed_block_v0,         // which = 7
                                     packed_transaction_v0,   // which = 8
                                     signed_block,            // which = 9
-                                    trx_message_v1>;         // which = 10
+                                    trx_message_v1,          // which = 10
+                                    compact_block_message,   // which = 11
+                                    request_compact_trxs_message,
+                                    compact_trxs_message,
+                                    sync_compression_message,
+                                    compressed_block_message>;
 
 } // namespace eosio
 
@@ -170,6 +216,12 @@ FC_REFLECT( eosio::notice_message, (known_trx)(known_blocks) )
 FC_REFLECT( eosio::request_message, (req_trx)(req_blocks) )
 FC_REFLECT( eosio::sync_request_message, (start_block)(end_block) )
 FC_REFLECT( eosio::trx_message_v1, (trx_id)(trx) )
+FC_REFLECT_DERIVED( eosio::compact_trx_receipt, (eosio::chain::transaction_receipt_header), (trx) )
+FC_REFLECT( eosio::compact_block_message, (header)(prune_state)(transactions)(block_extensions) )
+FC_REFLECT( eosio::request_compact_trxs_message, (id)(indexes) )
+FC_REFLECT( eosio::compact_trxs_message, (id)(trxs) )
+FC_REFLECT( eosio::sync_compression_message, (accept_compressed_blocks) )
+FC_REFLECT( eosio::compressed_block_message, (header)(uncompressed_size)(data) )
 
 
 /**
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+namespace eosio {
+
+   /**
+    * Expected time in microseconds for a peer to deliver span sync blocks, lower is better.
+    * Each recent failure doubles the expected time. A peer that has not delivered a sync block yet is unmeasured:
+    * without failures it scores 0 so it is tried and measured, with failures it ranks below every measured peer.
+    */
+   inline int64_t sync_score( int64_t block_interval_us, int64_t rtt_us, uint32_t failures, uint32_t span ) {
+      constexpr uint32_t max_failure_shift = 16;
+      const uint32_t shift = std::min( failures, max_failure_shift );
+      if( block_interval_us == 0 ) {
+         if( failures == 0 ) return 0;
+         return std::numeric_limits<int64_t>::max() - max_failure_shift + shift;
+      }
+      return (block_interval_us * span + rtt_us) << shift;
+   }
+
+   /**
+    * Returns the candidate with the lowest score, scanning from start and wrapping around so ties go to the first
+    * candidate at or after start. score(candidate) returns an empty optional for candidates that can not be selected.
+    * Returns end if there is none.
+    */
+   template<typename Itr, typename Score>
+   Itr select_sync_source( Itr begin, Itr end, Itr start, Score&& score ) {
+      if( begin == end ) return end;
+      Itr best = end;
+      int64_t best_score = 0;
+      Itr itr = start;
+      do {
+         std::optional<int64_t> s = score( *itr );
+         if( s && (best == end || *s < best_score) ) {
+            best = itr;
+            best_score = *s;
+         }
+         if( ++itr == end )
+            itr = begin;
+      } while( itr != start );
+      return best;
+   }
+
+} // namespace eosio
@@ -2,6 +2,7 @@
 
 #include <eosio/net_plugin/net_plugin.hpp>
 #include <eosio/net_plugin/protocol.hpp>
+#include <eosio/net_plugin/sync_source_selection.hpp>
 #include <eosio/chain/controller.hpp>
 #include <eosio/chain/exceptions.hpp>
 #include <eosio/chain/block.hpp>
@@ -9,6 +10,7 @@
 #include <eosio/chain/thread_utils.hpp>
 #include <eosio/producer_plugin/producer_plugin.hpp>
 #include <eosio/chain/contract_types.hpp>
+#include <eosio/chain/merkle.hpp>
 
 #include <fc/network/message_buffer.hpp>
 #include <fc/network/ip.hpp>
@@ -20,12 +22,25 @@
 #include <fc/reflect/variant.hpp>
 #include <fc/crypto/rand.hpp>
 #include <fc/exception/exception.hpp>
+#include <fc/scoped_exit.hpp>
 
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ip/host_name.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
 
+#include <sys/un.h>
+
+#include <array>
 #include <atomic>
+#include <cstring>
 #include <shared_mutex>
 
 using namespace eosio::chain::plugin_interface;
@@ -36,9 +51,15 @@ namespace eosio {
    using std::vector;
 
    using boost::asio::ip::tcp;
+   namespace local = boost::asio::local;
+   /// tcp or unix domain socket
+   using stream_socket = boost::asio::generic::stream_protocol::socket;
    using boost::asio::ip::address_v4;
    using boost::asio::ip::host_name;
    using boost::multi_index_container;
+   using boost::multi_index::hashed_unique;
+   using boost::multi_index::hashed_non_unique;
+   using boost::multi_index::sequenced;
 
    using fc::time_point;
    using fc::time_point_sec;
@@ -46,6 +67,7 @@ namespace eosio {
    using eosio::chain::sha256_less;
 
    class connection;
+   class block_buffer_cache;
 
    using connection_ptr = std::shared_ptr<connection>;
    using connection_wptr = std::weak_ptr<connection>;
@@ -60,6 +82,55 @@ namespace eosio {
       }
    }
 
+   constexpr auto unix_socket_prefix = "unix:";
+
+   /// peer address of the form unix:<path>[:<trx>|<blk>]
+   bool is_local_peer_address( const string& peer_addr ) {
+      return peer_addr.rfind( unix_socket_prefix, 0 ) == 0;
+   }
+
+   /// trailing connection type of a unix peer address, empty if none; any other ':' is part of the path
+   string local_socket_type( const string& peer_addr ) {
+      const auto start = std::strlen( unix_socket_prefix );
+      for( const char* type : { ":trx", ":blk" } ) {
+         const auto len = std::strlen( type );
+         if( peer_addr.size() >= start + len && peer_addr.compare( peer_addr.size() - len, len, type ) == 0 )
+            return type + 1;
+      }
+      return {};
+   }
+
+   string local_socket_path( const string& peer_addr ) {
+      const auto start = std::strlen( unix_socket_prefix );
+      const auto type = local_socket_type( peer_addr );
+      const auto end = peer_addr.size() - ( type.empty() ? 0 : type.size() + 1 );
+      return peer_addr.substr( start, end - start );
+   }
+
+   /// a path that fits in sockaddr_un, local::stream_protocol::endpoint throws otherwise
+   bool valid_local_socket_path( const string& path ) {
+      return !path.empty() && path.size() < sizeof( sockaddr_un::sun_path );
+   }
+
+   bool is_local_socket( const stream_socket& socket ) {
+      boost::system::error_code ec;
+      return socket.local_endpoint( ec ).protocol().family() == AF_UNIX;
+   }
+
+   /// address and port of an ip endpoint, "unix" and the socket path of a unix domain socket endpoint
+   std::pair<string, string> to_address_port( const stream_socket::endpoint_type& ep ) {
+      if( ep.protocol().family() == AF_UNIX ) {
+         local::stream_protocol::endpoint lep;
+         std::memcpy( lep.data(), ep.data(), ep.size() );
+         lep.resize( ep.size() );
+         return { "unix", lep.path() };
+      }
+      tcp::endpoint tep;
+      std::memcpy( tep.data(), ep.data(), ep.size() );
+      tep.resize( ep.size() );
+      return { tep.address().to_string(), std::to_string( tep.port() ) };
+   }
+
    struct node_transaction_state {
       transaction_id_type id;
       time_point_sec  expires;        /// time after which this may be purged.
@@ -69,27 +140,99 @@ namespace eosio {
 
    struct by_expiry;
    struct by_block_num;
+   struct by_short_id;
 
-   typedef multi_index_container<
-      node_transaction_state,
-      indexed_by<
-         ordered_unique<
-            tag<by_id>,
-            composite_key< node_transaction_state,
-               member<node_transaction_state, transaction_id_type, &node_transaction_state::id>,
-               member<node_transaction_state, uint32_t, &node_transaction_state::connection_id>
-            >,
-            composite_key_compare< sha256_less, std::less<uint32_t> >
-         >,
-         ordered_non_unique<
-            tag< by_expiry >,
-            member< node_transaction_state, fc::time_point_sec, &node_transaction_state::expires > >,
-         ordered_non_unique<
-            tag<by_block_num>,
-            member< node_transaction_state, uint32_t, &node_transaction_state::block_num > >
+   /**
+    * Transactions known to this node, along with the connections known to have them. Sharded by transaction id so
+    * that connection strands receiving different transactions rarely contend on the same mutex. Each shard holds a
+    * single entry per transaction id with the set of connection ids that have the transaction.
+    * Thread safe.
+    */
+   class node_transaction_table {
+   public:
+      static constexpr size_t num_shards = 64;
+
+      /// returns true if connection_id was not already known to have id, trx is retained for compact block reconstruction
+      bool add( const node_transaction_state& nts, const packed_transaction_ptr& trx = packed_transaction_ptr() );
+      /// only adds connection_id if id is already known, returns has( id )
+      bool add_if_known( const transaction_id_type& id, uint32_t connection_id );
+      void update_block_num( const transaction_id_type& id, uint32_t block_num );
+      bool peer_has( const transaction_id_type& id, uint32_t connection_id ) const;
+      bool has( const transaction_id_type& id ) const;
+      /// returns retained packed_transaction matching the short id, nullptr if not known
+      packed_transaction_ptr get_trx( short_trx_id_type short_id ) const;
+      /// removes expired entries and entries included in blocks up to lib_num, one shard at a time, returns number removed
+      size_t expire( uint32_t lib_num, const time_point_sec& now );
+      size_t size() const;
+
+   private:
+      struct txn_entry {
+         transaction_id_type id;
+         time_point_sec      expires;
+         uint32_t            block_num = 0;
+         mutable flat_set<uint32_t> connection_ids; ///< not part of any index
+         mutable packed_transaction_ptr trx;        ///< not part of any index
+
+         short_trx_id_type short_id() const { return short_trx_id( id ); }
+      };
+
+      typedef multi_index_container<
+         txn_entry,
+         indexed_by<
+            hashed_unique< tag<by_id>, member<txn_entry, transaction_id_type, &txn_entry::id>, std::hash<transaction_id_type> >,
+            ordered_non_unique< tag<by_expiry>, member<txn_entry, fc::time_point_sec, &txn_entry::expires> >,
+            ordered_non_unique< tag<by_block_num>, member<txn_entry, uint32_t, &txn_entry::block_num> >,
+            hashed_non_unique< tag<by_short_id>, const_mem_fun<txn_entry, short_trx_id_type, &txn_entry::short_id> >
          >
-      >
-   node_transaction_index;
+      > txn_entry_index;
+
+      struct shard {
+         mutable std::mutex mtx;
+         txn_entry_index    txns;
+      };
+
+      // id is a sha256 so any word of it is uniformly distributed, short_trx_id uses a different word than std::hash does
+      shard& shard_for( const transaction_id_type& id ) { return shards[short_trx_id( id ) % num_shards]; }
+      const shard& shard_for( const transaction_id_type& id ) const { return shards[short_trx_id( id ) % num_shards]; }
+      const shard& shard_for( short_trx_id_type short_id ) const { return shards[short_id % num_shards]; }
+
+      std::array<shard, num_shards> shards;
+   };
+
+   /**
+    * Keys recently recovered from incoming transactions, keyed by signature digest. A transaction received again after
+    * it has been purged from the node_transaction_table, e.g. rejected and later rebroadcast by a peer, reuses the
+    * recovered keys instead of paying for recovery again. Entries are only used when the signatures match exactly.
+    * Bounded, oldest entries evicted first. Thread safe.
+    */
+   class recovered_keys_cache {
+   public:
+      explicit recovered_keys_cache( size_t max_entries ) : max_entries( max_entries ) {}
+
+      /// returns transaction_metadata for trx created from cached keys, nullptr if not cached
+      transaction_metadata_ptr get( const digest_type& digest, const packed_transaction_ptr& trx ) const;
+      void add( const digest_type& digest, const transaction_metadata_ptr& trx_meta );
+
+   private:
+      struct entry {
+         digest_type               digest;
+         vector<signature_type>    signatures;
+         fc::microseconds          sig_cpu_usage;
+         flat_set<public_key_type> recovered_keys;
+      };
+
+      typedef multi_index_container<
+         entry,
+         indexed_by<
+            sequenced<>,
+            hashed_unique< tag<by_id>, member<entry, digest_type, &entry::digest>, std::hash<digest_type> >
+         >
+      > entry_index;
+
+      mutable std::mutex mtx;
+      entry_index        entries;
+      const size_t       max_entries;
+   };
 
    struct peer_block_state {
       block_id_type id;
@@ -122,14 +265,6 @@ namespace eosio {
       > peer_block_state_index;
 
 
-   struct update_block_num {
-      uint32_t new_bnum;
-      update_block_num(uint32_t bnum) : new_bnum(bnum) {}
-      void operator() (node_transaction_state& nts) {
-         nts.block_num = new_bnum;
-      }
-   };
-
    class sync_manager {
    private:
       enum stages {
@@ -138,12 +273,32 @@ namespace eosio {
          in_sync
       };
 
+      /// range of blocks requested from a single peer
+      struct sync_chunk {
+         uint32_t       start = 0;
+         uint32_t       end = 0;
+         connection_ptr source;
+      };
+
+      /// block received ahead of the next block to apply during lib_catchup
+      struct pending_sync_block {
+         block_id_type    id;
+         signed_block_ptr block;
+         connection_ptr   source;
+         uint32_t         generation = 0; ///< sync_dispatch_generation when dispatched
+      };
+
       mutable std::mutex sync_mtx;
       uint32_t       sync_known_lib_num{0};
       uint32_t       sync_last_requested_num{0};
       uint32_t       sync_next_expected_num{0};
       uint32_t       sync_req_span{0};
+      uint32_t       sync_max_sources{1};
+      uint32_t       sync_next_dispatch_num{0}; ///< next block number to hand to the main thread in lib_catchup
       connection_ptr sync_source;
+      std::deque<sync_chunk> sync_chunks; ///< outstanding requests ordered by block number, at most sync_max_sources
+      std::map<uint32_t, pending_sync_block> sync_reorder_buffer; ///< keyed by block number
+      std::atomic<uint32_t> sync_dispatch_generation{0}; ///< incremented when a dispatched block is rejected
       std::atomic<stages> sync_state{in_sync};
 
    private:
@@ -151,17 +306,26 @@ namespace eosio {
       bool set_state( stages s );
       bool is_sync_required( uint32_t fork_head_block_num );
       void request_next_chunk( std::unique_lock<std::mutex> g_sync, const connection_ptr& conn = connection_ptr() );
+      void advance_sync_source();
+      bool is_sync_source( const connection_ptr& c ) const;
+      void reset_sync_chunks();
+      void reset_sync_reorder();
+      void dispatch_sync_block( pending_sync_block&& pending );
       void start_sync( const connection_ptr& c, uint32_t target );
       bool verify_catchup( const connection_ptr& c, uint32_t num, const block_id_type& id );
 
    public:
-      explicit sync_manager( uint32_t span );
+      sync_manager( uint32_t span, uint32_t max_sources );
       static void send_handshakes();
       bool syncing_with_peer() const { return sync_state == lib_catchup; }
       void sync_reset_lib_num( const connection_ptr& conn );
       void sync_reassign_fetch( const connection_ptr& c, go_away_reason reason );
       void rejected_block( const connection_ptr& c, uint32_t blk_num );
+      void rejected_reordered_block( uint32_t blk_num );
+      bool is_stale_dispatch( uint32_t generation ) const { return generation != sync_dispatch_generation; }
+      void sync_invalid_block( const connection_ptr& c, uint32_t blk_num );
       void sync_recv_block( const connection_ptr& c, const block_id_type& blk_id, uint32_t blk_num, bool blk_applied );
+      bool sync_reorder_block( const connection_ptr& c, const block_id_type& blk_id, const signed_block_ptr& ptr );
       void sync_update_expected( const connection_ptr& c, const block_id_type& blk_id, uint32_t blk_num, bool blk_applied );
       void recv_handshake( const connection_ptr& c, const handshake_message& msg );
       void sync_recv_notice( const connection_ptr& c, const notice_message& msg );
@@ -170,8 +334,7 @@ namespace eosio {
    class dispatch_manager {
       mutable std::mutex      blk_state_mtx;
       peer_block_state_index  blk_state;
-      mutable std::mutex      local_txns_mtx;
-      node_transaction_index  local_txns;
+      node_transaction_table  local_txns;
 
    public:
       boost::asio::io_context::strand  strand;
@@ -194,22 +357,26 @@ namespace eosio {
       bool peer_has_block(const block_id_type& blkid, uint32_t connection_id) const;
       bool have_block(const block_id_type& blkid) const;
 
-      bool add_peer_txn( const node_transaction_state& nts );
+      bool add_peer_txn( const node_transaction_state& nts, const packed_transaction_ptr& trx = packed_transaction_ptr() );
       bool add_peer_txn( const transaction_id_type& tid, uint32_t connection_id );
       void update_txns_block_num( const signed_block_ptr& sb );
       void update_txns_block_num( const transaction_id_type& id, uint32_t blk_num );
       bool peer_has_txn( const transaction_id_type& tid, uint32_t connection_id ) const;
       bool have_txn( const transaction_id_type& tid ) const;
+      packed_transaction_ptr get_txn( short_trx_id_type short_id ) const;
       void expire_txns( uint32_t lib_num );
    };
 
    class net_plugin_impl : public std::enable_shared_from_this<net_plugin_impl> {
    public:
       unique_ptr<tcp::acceptor>        acceptor;
+      unique_ptr<local::stream_protocol::acceptor> local_acceptor;
       std::atomic<uint32_t>            current_connection_id{0};
 
       unique_ptr< sync_manager >       sync_master;
       unique_ptr< dispatch_manager >   dispatcher;
+      unique_ptr< block_buffer_cache > block_buffers;
+      unique_ptr< recovered_keys_cache > recovered_keys;
 
       /**
        * Thread safe, only updated in plugin initialize
@@ -217,6 +384,7 @@ namespace eosio {
        */
       string                                p2p_address;
       string                                p2p_server_address;
+      string                                p2p_listen_unix_socket;
 
       vector<string>                        supplied_peers;
       vector<chain::public_key_type>        allowed_peers; ///< peer keys allowed to connect
@@ -241,6 +409,11 @@ namespace eosio {
       uint32_t                              max_nodes_per_host = 1;
       bool                                  p2p_accept_transactions = true;
       bool                                  p2p_reject_incomplete_blocks = true;
+      bool                                  p2p_accept_compressed_sync_blocks = true;
+      uint32_t                              p2p_sync_compression_min_size = 0;
+      uint32_t                              trx_recovery_batch_size = def_trx_recovery_batch_size;
+      uint32_t                              max_signature_length = UINT32_MAX;
+      boost::asio::io_context*              chain_thread_pool = nullptr; ///< controller thread pool, used for signature recovery
 
       /// Peer clock may be no more than 1 second skewed from our clock, including network latency.
       const std::chrono::system_clock::duration peer_authentication_interval{std::chrono::seconds{1}};
@@ -288,7 +461,8 @@ namespace eosio {
       //         lib_num, head_block_num, fork_head_blk_num, lib_id, head_blk_id, fork_head_blk_id
       std::tuple<uint32_t, uint32_t, uint32_t, block_id_type, block_id_type, block_id_type> get_chain_info() const;
 
-      void start_listen_loop();
+      template<typename Acceptor>
+      void start_listen_loop( Acceptor& acc );
 
       void on_accepted_block( const block_state_ptr& bs );
       void on_pre_accepted_block( const signed_block_ptr& bs );
@@ -316,6 +490,15 @@ namespace eosio {
        * \return False if the peer should not connect, true otherwise.
        */
       bool authenticate_peer(const handshake_message& msg) const;
+      /** \brief Determine if an authenticated peer is trusted.
+       *
+       * A peer is trusted if its handshake is signed by a key configured via peer-key, peer-private-key
+       * or by one of our producer keys. Transactions from trusted peers are given priority on the main thread.
+       */
+      bool is_trusted_peer(const handshake_message& msg) const;
+
+      transaction_metadata_ptr recover_trx_keys( const packed_transaction_ptr& trx, const fc::microseconds& time_limit ) const;
+      void recover_trx_batch( vector<packed_transaction_ptr> batch, bool trusted, const connection_wptr& weak ) const;
       /** \brief Retrieve public key used to authenticate with peers.
        *
        * Finds a key to use for authentication.  If this node is a producer, use
@@ -390,13 +573,20 @@ namespace eosio {
    constexpr auto     def_txn_expire_wait = std::chrono::seconds(3);
    constexpr auto     def_resp_expected_wait = std::chrono::seconds(5);
    constexpr auto     def_sync_fetch_span = 100;
+   constexpr auto     def_sync_fetch_peers = 1;
+   constexpr auto     def_block_buffer_cache_size_mb = 64;
    constexpr auto     def_keepalive_interval = 32000;
+   constexpr auto     def_sync_compression_min_size = 4*1024; // smaller blocks are not worth the cpu to compress
+   constexpr auto     def_trx_recovery_batch_size = 32;
+   constexpr auto     def_recovered_keys_cache_size = 16*1024;
 
    constexpr auto     message_header_size = 4;
    constexpr uint32_t signed_block_v0_which       = fc::get_index<net_message, signed_block_v0>();       // see protocol net_message
    constexpr uint32_t packed_transaction_v0_which = fc::get_index<net_message, packed_transaction_v0>(); // see protocol net_message
    constexpr uint32_t signed_block_which          = fc::get_index<net_message, signed_block>();          // see protocol net_message
    constexpr uint32_t trx_message_v1_which        = fc::get_index<net_message, trx_message_v1>();        // see protocol net_message
+   constexpr uint32_t compact_block_message_which = fc::get_index<net_message, compact_block_message>(); // see protocol net_message
+   constexpr uint32_t compressed_block_message_which = fc::get_index<net_message, compressed_block_message>(); // see protocol net_message
 
    /**
     *  For a while, network version was a 16 bit value equal to the second set of 16 bits
@@ -422,8 +612,49 @@ namespace eosio {
    constexpr uint16_t proto_pruned_types = 3;        // supports new signed_block & packed_transaction types
    constexpr uint16_t heartbeat_interval = 4;        // supports configurable heartbeat interval
    constexpr uint16_t dup_goaway_resolution = 5;     // support peer address based duplicate connection resolution
+   constexpr uint16_t proto_compact_blocks = 6;      // supports compact_block_message relay of blocks with short trx ids
+   constexpr uint16_t proto_sync_compression = 7;    // supports sync_compression_message & compressed_block_message
+
+   constexpr uint16_t net_version = proto_sync_compression;
+
+   constexpr std::array<const char*, std::variant_size_v<net_message>> net_message_names = {
+      "handshake_message", "chain_size_message", "go_away_message", "time_message", "notice_message",
+      "request_message", "sync_request_message", "signed_block_v0", "packed_transaction_v0", "signed_block",
+      "trx_message_v1", "compact_block_message", "request_compact_trxs_message", "compact_trxs_message",
+      "sync_compression_message", "compressed_block_message"
+   };
+
+   /**
+    * Counters of traffic with a single peer, reset when the connection is closed.
+    * Lock free, updated from the connection strand and read from any thread.
+    */
+   class connection_counters {
+   public:
+      static constexpr std::array<uint32_t, 7> block_latency_bounds_ms = { 50, 100, 250, 500, 1000, 2000, 5000 };
+
+      std::atomic<uint64_t> bytes_received{0};
+      std::atomic<uint64_t> bytes_sent{0};
+      std::atomic<uint64_t> message_processing_us{0};
+      std::atomic<uint64_t> trxs_received{0};
+      std::atomic<uint64_t> duplicate_trxs_received{0};
+      std::atomic<uint64_t> blocks_received{0};
+      std::atomic<uint64_t> duplicate_blocks_received{0};
+
+      connection_counters() { reset(); }
+
+      void message_received( uint32_t which ) {
+         if( which < messages_received.size() ) ++messages_received[which];
+      }
+      void block_latency( const fc::microseconds& latency );
+      void reset();
+      /// fills in all but peer, connection_id and write_queue_bytes
+      void get( connection_metrics& m ) const;
 
-   constexpr uint16_t net_version = dup_goaway_resolution;
+   private:
+      std::atomic<int64_t> since_us{0};
+      std::array<std::atomic<uint64_t>, std::variant_size_v<net_message>> messages_received{};
+      std::array<std::atomic<uint64_t>, block_latency_bounds_ms.size() + 1> block_latency_histogram{};
+   };
 
    /**
     * Index by start_block_num
@@ -573,6 +804,13 @@ namespace eosio {
       block_status_monitor& operator=( block_status_monitor&& ) = delete;
    };
 
+   /// serialized form of a signed_block sent to a peer, depends on peer protocol version
+   enum class block_buffer_kind : uint8_t {
+      signed_block,    ///< peer >= proto_pruned_types
+      signed_block_v0, ///< peer < proto_pruned_types
+      compressed       ///< sync to peer that accepts compressed_block_message
+   };
+
    class connection : public std::enable_shared_from_this<connection> {
    public:
       explicit connection( string endpoint );
@@ -613,22 +851,32 @@ namespace eosio {
 
    public:
       boost::asio::io_context::strand           strand;
-      std::shared_ptr<tcp::socket>              socket; // only accessed through strand after construction
+      std::shared_ptr<stream_socket>            socket; // only accessed through strand after construction
 
       fc::message_buffer<1024*1024>    pending_message_buffer;
       std::atomic<std::size_t>         outstanding_read_bytes{0}; // accessed only from strand threads
 
       queued_buffer           buffer_queue;
+      connection_counters     counters;
 
       std::atomic<uint32_t>   trx_in_progress_size{0};
+      vector<packed_transaction_ptr> pending_trx_batch; // accessed only from strand threads
+      bool                    trusted_peer = false;     // accessed only from strand threads
       const uint32_t          connection_id;
       int16_t                 sent_handshake_count = 0;
       std::atomic<bool>       connecting{true};
       std::atomic<bool>       syncing{false};
 
       std::atomic<uint16_t>   protocol_version = 0;
+      std::atomic<bool>       peer_accepts_compressed_blocks{false};
       uint16_t                consecutive_rejected_blocks = 0;
       block_status_monitor    block_status_monitor_;
+
+      // measurements used to choose sync sources, see sync_manager::advance_sync_source
+      std::atomic<int64_t>    rtt_us{0};                 ///< smoothed round trip time of time_message exchanges, 0 until measured
+      std::atomic<int64_t>    sync_block_interval_us{0}; ///< smoothed time between sync blocks received, 0 until measured
+      std::atomic<uint32_t>   sync_failures{0};          ///< rejected blocks and sync timeouts, halved on each completed chunk
+      fc::time_point          last_sync_block_time;      ///< accessed only from strand
       std::atomic<uint16_t>   consecutive_immediate_connection_close = 0;
 
       std::mutex                            response_expected_timer_mtx;
@@ -650,6 +898,7 @@ namespace eosio {
       string                           local_endpoint_port;
 
       connection_status get_status()const;
+      connection_metrics get_metrics()const;
 
       /** \name Peer Timestamps
        *  Time message handling
@@ -676,12 +925,32 @@ namespace eosio {
 
       bool process_next_block_message(uint32_t message_length);
       bool process_next_trx_message(uint32_t message_length);
+      bool accept_block_header( const block_id_type& blk_id, const block_header& bh );
+      bool process_block( const block_id_type& blk_id, signed_block_ptr ptr );
+      void process_compact_block( const block_id_type& blk_id, signed_block_ptr ptr );
+
+      void request_full_block( const block_id_type& blk_id );
+
+      /// compact block waiting on transactions requested via request_compact_trxs_message, only accessed from strand
+      struct pending_compact_block {
+         block_id_type     id;
+         signed_block_ptr  block;
+         vector<uint32_t>  missing; ///< indexes into block->transactions
+      };
+      static constexpr size_t max_pending_compact_blocks = 4;
+      deque<pending_compact_block> pending_compacts; ///< oldest first, at most max_pending_compact_blocks
+      /// blocks sent to the peer as compact_block_message, serves its request_compact_trxs_message, only accessed from strand
+      deque<std::pair<block_id_type, signed_block_ptr>> sent_compacts; ///< oldest first, at most max_pending_compact_blocks
    public:
 
       bool populate_handshake( handshake_message& hello, bool force );
 
       bool resolve_and_connect();
       void connect( const std::shared_ptr<tcp::resolver>& resolver, tcp::resolver::results_type endpoints );
+      void connect( const local::stream_protocol::endpoint& endpoint );
+      /// reset connection state for a new connection attempt, false if the peer should not be retried
+      bool prepare_connect();
+      void on_connect( const boost::system::error_code& err, const std::shared_ptr<stream_socket>& socket );
       void start_read_message();
 
       /** \brief Process the next message from the pending message buffer
@@ -728,14 +997,20 @@ namespace eosio {
       void stop_send();
 
       void enqueue( const net_message &msg );
-      void enqueue_block( const signed_block_ptr& sb, bool to_sync_queue = false);
+      void enqueue_block( const signed_block_ptr& sb, bool to_sync_queue = false, bool irreversible = false );
+      block_buffer_kind block_buffer_kind_for( bool to_sync_queue ) const;
       void enqueue_buffer( const std::shared_ptr<std::vector<char>>& send_buffer,
                            go_away_reason close_after_send,
                            bool to_sync_queue = false);
+      /// called from connection strand after enqueueing a compact_block_message of sb
+      void add_sent_compact( const block_id_type& id, const signed_block_ptr& sb );
       void cancel_sync(go_away_reason);
       void flush_queues();
       bool enqueue_sync_block();
       void request_sync_blocks(uint32_t start, uint32_t end);
+      void record_sync_block_arrival();
+      /// expected time in microseconds to deliver span blocks, lower is better, 0 if not yet measured
+      int64_t sync_score( uint32_t span ) const;
 
       void cancel_wait();
       void sync_wait();
@@ -775,8 +1050,15 @@ namespace eosio {
       void handle_message( const block_id_type& id, signed_block_ptr msg );
       void handle_message( const packed_transaction& msg ) = delete; // packed_transaction_ptr overload used instead
       void handle_message( packed_transaction_ptr msg );
+      void handle_message( const compact_block_message& msg );
+      void handle_message( const request_compact_trxs_message& msg );
+      void handle_message( const compact_trxs_message& msg );
+      void handle_message( const sync_compression_message& msg );
+      void handle_message( const compressed_block_message& msg );
 
-      void process_signed_block( const block_id_type& id, signed_block_ptr msg );
+      void process_signed_block( const block_id_type& id, signed_block_ptr msg, bool reordered = false );
+      /// submit transactions received since the last flush for key recovery as a single batch
+      void flush_trx_batch();
 
       fc::variant_object get_logger_variant()  {
          fc::mutable_variant_object mvo;
@@ -845,6 +1127,36 @@ namespace eosio {
          fc_dlog( logger, "handle sync_request_message" );
          c->handle_message( msg );
       }
+
+      void operator()( const compact_block_message& msg ) const {
+         // continue call to handle_message on connection strand
+         fc_dlog( logger, "handle compact_block_message" );
+         c->handle_message( msg );
+      }
+
+      void operator()( const request_compact_trxs_message& msg ) const {
+         // continue call to handle_message on connection strand
+         fc_dlog( logger, "handle request_compact_trxs_message" );
+         c->handle_message( msg );
+      }
+
+      void operator()( const compact_trxs_message& msg ) const {
+         // continue call to handle_message on connection strand
+         fc_dlog( logger, "handle compact_trxs_message" );
+         c->handle_message( msg );
+      }
+
+      void operator()( const sync_compression_message& msg ) const {
+         // continue call to handle_message on connection strand
+         fc_dlog( logger, "handle sync_compression_message" );
+         c->handle_message( msg );
+      }
+
+      void operator()( const compressed_block_message& msg ) const {
+         // continue call to handle_message on connection strand
+         fc_dlog( logger, "handle compressed_block_message" );
+         c->handle_message( msg );
+      }
    };
 
    template<typename Function>
@@ -869,7 +1181,7 @@ namespace eosio {
    connection::connection( string endpoint )
       : peer_addr( endpoint ),
         strand( my_impl->thread_pool->get_executor() ),
-        socket( new tcp::socket( my_impl->thread_pool->get_executor() ) ),
+        socket( new stream_socket( my_impl->thread_pool->get_executor() ) ),
         connection_id( ++my_impl->current_connection_id ),
         response_expected_timer( my_impl->thread_pool->get_executor() ),
         last_handshake_recv(),
@@ -881,7 +1193,7 @@ namespace eosio {
    connection::connection()
       : peer_addr(),
         strand( my_impl->thread_pool->get_executor() ),
-        socket( new tcp::socket( my_impl->thread_pool->get_executor() ) ),
+        socket( new stream_socket( my_impl->thread_pool->get_executor() ) ),
         connection_id( ++my_impl->current_connection_id ),
         response_expected_timer( my_impl->thread_pool->get_executor() ),
         last_handshake_recv(),
@@ -895,23 +1207,29 @@ namespace eosio {
       boost::system::error_code ec2;
       auto rep = socket->remote_endpoint(ec);
       auto lep = socket->local_endpoint(ec2);
+      auto remote = ec ? std::make_pair( unknown, unknown ) : to_address_port( rep );
+      auto local = ec2 ? std::make_pair( unknown, unknown ) : to_address_port( lep );
       std::lock_guard<std::mutex> g_conn( conn_mtx );
-      remote_endpoint_ip = ec ? unknown : rep.address().to_string();
-      remote_endpoint_port = ec ? unknown : std::to_string(rep.port());
-      local_endpoint_ip = ec2 ? unknown : lep.address().to_string();
-      local_endpoint_port = ec2 ? unknown : std::to_string(lep.port());
+      remote_endpoint_ip = std::move( remote.first );
+      remote_endpoint_port = std::move( remote.second );
+      local_endpoint_ip = std::move( local.first );
+      local_endpoint_port = std::move( local.second );
    }
 
    void connection::set_connection_type( const string& peer_add ) {
-      // host:port:[<trx>|<blk>]
-      string::size_type colon = peer_add.find(':');
-      string::size_type colon2 = peer_add.find(':', colon + 1);
-      string::size_type end = colon2 == string::npos
-            ? string::npos : peer_add.find_first_of( " :+=.,<>!$%^&(*)|-#@\t", colon2 + 1 ); // future proof by including most symbols without using regex
-      string host = peer_add.substr( 0, colon );
-      string port = peer_add.substr( colon + 1, colon2 == string::npos ? string::npos : colon2 - (colon + 1));
-      string type = colon2 == string::npos ? "" : end == string::npos ?
-            peer_add.substr( colon2 + 1 ) : peer_add.substr( colon2 + 1, end - (colon2 + 1) );
+      string type;
+      if( is_local_peer_address( peer_add ) ) {
+         // unix:<path>[:<trx>|<blk>]
+         type = local_socket_type( peer_add );
+      } else {
+         // host:port:[<trx>|<blk>]
+         string::size_type colon = peer_add.find(':');
+         string::size_type colon2 = peer_add.find(':', colon + 1);
+         string::size_type end = colon2 == string::npos
+               ? string::npos : peer_add.find_first_of( " :+=.,<>!$%^&(*)|-#@\t", colon2 + 1 ); // future proof by including most symbols without using regex
+         type = colon2 == string::npos ? "" : end == string::npos ?
+               peer_add.substr( colon2 + 1 ) : peer_add.substr( colon2 + 1, end - (colon2 + 1) );
+      }
 
       if( type.empty() ) {
          fc_dlog( logger, "Setting connection type for: ${peer} to both transactions and blocks", ("peer", peer_add) );
@@ -937,13 +1255,66 @@ namespace eosio {
       return stat;
    }
 
+   connection_metrics connection::get_metrics()const {
+      connection_metrics m;
+      m.peer = peer_address();
+      m.connection_id = connection_id;
+      m.write_queue_bytes = buffer_queue.write_queue_size();
+      counters.get( m );
+      m.rtt_us = rtt_us;
+      m.sync_block_interval_us = sync_block_interval_us;
+      m.sync_failures = sync_failures;
+      return m;
+   }
+
+   void connection_counters::block_latency( const fc::microseconds& latency ) {
+      const auto latency_ms = latency.count() / 1000;
+      size_t i = 0;
+      while( i < block_latency_bounds_ms.size() && latency_ms > block_latency_bounds_ms[i] ) ++i;
+      ++block_latency_histogram[i];
+   }
+
+   void connection_counters::reset() {
+      since_us = fc::time_point::now().time_since_epoch().count();
+      bytes_received = 0;
+      bytes_sent = 0;
+      message_processing_us = 0;
+      trxs_received = 0;
+      duplicate_trxs_received = 0;
+      blocks_received = 0;
+      duplicate_blocks_received = 0;
+      for( auto& c : messages_received ) c = 0;
+      for( auto& c : block_latency_histogram ) c = 0;
+   }
+
+   void connection_counters::get( connection_metrics& m ) const {
+      m.since = fc::time_point( fc::microseconds( since_us.load() ) );
+      m.bytes_received = bytes_received;
+      m.bytes_sent = bytes_sent;
+      m.message_processing_us = message_processing_us;
+      m.trxs_received = trxs_received;
+      m.duplicate_trxs_received = duplicate_trxs_received;
+      m.blocks_received = blocks_received;
+      m.duplicate_blocks_received = duplicate_blocks_received;
+      fc::mutable_variant_object msgs;
+      for( size_t i = 0; i < messages_received.size(); ++i ) {
+         if( uint64_t c = messages_received[i] ) msgs( net_message_names[i], c );
+      }
+      m.messages_received = std::move( msgs );
+      m.block_latency_bounds_ms.assign( block_latency_bounds_ms.begin(), block_latency_bounds_ms.end() );
+      m.block_latency_histogram.reserve( block_latency_histogram.size() );
+      for( const auto& c : block_latency_histogram ) m.block_latency_histogram.push_back( c );
+   }
+
    bool connection::start_session() {
       verify_strand_in_this_thread( strand, __func__, __LINE__ );
 
       update_endpoints();
-      boost::asio::ip::tcp::no_delay nodelay( true );
       boost::system::error_code ec;
-      socket->set_option( nodelay, ec );
+      if( !is_local_socket( *socket ) ) {
+         boost::asio::ip::tcp::no_delay nodelay( true );
+         socket->set_option( nodelay, ec );
+      }
       if( ec ) {
          fc_elog( logger, "connection failed (set_option) ${peer}: ${e1}", ("peer", peer_name())( "e1", ec.message() ) );
          close();
@@ -978,13 +1349,16 @@ namespace eosio {
       self->socket_open = false;
       boost::system::error_code ec;
       if( self->socket->is_open() ) {
-         self->socket->shutdown( tcp::socket::shutdown_both, ec );
+         self->socket->shutdown( stream_socket::shutdown_both, ec );
          self->socket->close( ec );
       }
-      self->socket.reset( new tcp::socket( my_impl->thread_pool->get_executor() ) );
+      self->socket.reset( new stream_socket( my_impl->thread_pool->get_executor() ) );
       self->flush_queues();
       self->connecting = false;
       self->syncing = false;
+      self->peer_accepts_compressed_blocks = false;
+      self->pending_compacts.clear();
+      self->sent_compacts.clear();
       self->block_status_monitor_.reset();
       ++self->consecutive_immediate_connection_close;
       bool has_last_req = false;
@@ -1003,6 +1377,8 @@ namespace eosio {
       self->sent_handshake_count = 0;
       if( !shutdown) my_impl->sync_master->sync_reset_lib_num( self->shared_from_this() );
       fc_ilog( logger, "closing '${a}', ${p}", ("a", self->peer_address())("p", self->peer_name()) );
+      fc_dlog( logger, "traffic with ${p}: ${m}", ("p", self->peer_name())("m", self->get_metrics()) );
+      self->counters.reset();
       fc_dlog( logger, "canceling wait on ${p}", ("p", self->peer_name()) ); // peer_name(), do not hold conn_mtx
       self->cancel_wait();
 
@@ -1218,6 +1594,7 @@ namespace eosio {
                }
 
                c->buffer_queue.out_callback( ec, w );
+               c->counters.bytes_sent += w;
 
                c->enqueue_sync_block();
                c->do_queue_write();
@@ -1254,41 +1631,6 @@ namespace eosio {
       }
    }
 
-   bool connection::enqueue_sync_block() {
-      if( !peer_requested ) {
-         return false;
-      } else {
-         fc_dlog( logger, "enqueue sync block ${num}", ("num", peer_requested->last + 1) );
-      }
-      uint32_t num = ++peer_requested->last;
-      if(num == peer_requested->end_block) {
-         peer_requested.reset();
-         fc_ilog( logger, "completing enqueue_sync_block ${num} to ${p}", ("num", num)("p", peer_name()) );
-      }
-      connection_wptr weak = shared_from_this();
-      app().post( priority::medium, [num, weak{std::move(weak)}]() {
-         connection_ptr c = weak.lock();
-         if( !c ) return;
-         controller& cc = my_impl->chain_plug->chain();
-         signed_block_ptr sb;
-         try {
-            sb = cc.fetch_block_by_number( num );
-         } FC_LOG_AND_DROP();
-         if( sb ) {
-            c->strand.post( [c, sb{std::move(sb)}]() {
-               c->enqueue_block( sb, true );
-            });
-         } else {
-            c->strand.post( [c, num]() {
-               peer_ilog( c, "enqueue sync, unable to fetch block ${num}", ("num", num) );
-               c->send_handshake();
-            });
-         }
-      });
-
-      return true;
-   }
-
    //------------------------------------------------------------------------
 
    using send_buffer_type = std::shared_ptr<std::vector<char>>;
@@ -1345,6 +1687,62 @@ namespace eosio {
 
    };
 
+   namespace bio = boost::iostreams;
+
+   /// limits decompressed size of compressed_block_message, protects against zip bombs
+   struct decompress_limiter {
+      using char_type = char;
+      using category = bio::multichar_output_filter_tag;
+
+      explicit decompress_limiter( size_t limit ) : limit( limit ) {}
+
+      template<typename Sink>
+      std::streamsize write( Sink& sink, const char* s, std::streamsize count ) {
+         EOS_ASSERT( total + count <= limit, plugin_exception, "Exceeded uncompressed_size of compressed_block_message" );
+         total += count;
+         return bio::write( sink, s, count );
+      }
+
+      size_t limit = 0;
+      size_t total = 0;
+   };
+
+   bytes compress_block( const signed_block& sb ) {
+      // best_speed as the point is to keep sync bandwidth bound rather than cpu bound
+      bytes in = fc::raw::pack( sb );
+      bytes out;
+      bio::filtering_ostream comp;
+      comp.push( bio::zlib_compressor( bio::zlib::best_speed ) );
+      comp.push( bio::back_inserter( out ) );
+      bio::write( comp, in.data(), in.size() );
+      bio::close( comp );
+      return out;
+   }
+
+   signed_block_ptr decompress_block( const compressed_block_message& msg ) {
+      EOS_ASSERT( msg.uncompressed_size <= def_send_buffer_size*2, plugin_exception,
+                  "compressed_block_message uncompressed_size ${s} too large", ("s", msg.uncompressed_size) );
+      bytes out;
+      out.reserve( msg.uncompressed_size );
+      try {
+         bio::filtering_ostream decomp;
+         decomp.push( bio::zlib_decompressor() );
+         decomp.push( decompress_limiter( msg.uncompressed_size ) );
+         decomp.push( bio::back_inserter( out ) );
+         bio::write( decomp, msg.data.data(), msg.data.size() );
+         bio::close( decomp );
+      } catch( fc::exception& ) {
+         throw;
+      } catch( ... ) {
+         fc::unhandled_exception er( FC_LOG_MESSAGE( warn, "compressed_block_message decompression error" ), std::current_exception() );
+         throw er;
+      }
+      auto ptr = std::make_shared<signed_block>();
+      fc::datastream<const char*> ds( out.data(), out.size() );
+      fc::raw::unpack( ds, *ptr );
+      return ptr;
+   }
+
    struct block_buffer_factory : public buffer_factory {
 
       /// caches result for subsequent calls, only provide same signed_block_ptr instance for each invocation.
@@ -1365,11 +1763,60 @@ namespace eosio {
          }
       }
 
+      /// caches result for subsequent calls, only provide same signed_block_ptr instance for each invocation.
+      /// only valid for protocol_version >= proto_compact_blocks
+      const send_buffer_type& get_compact_send_buffer( const signed_block_ptr& sb ) {
+         if( !compact_send_buffer ) {
+            compact_send_buffer = create_compact_send_buffer( sb );
+         }
+         return compact_send_buffer;
+      }
+
+      /// caches result for subsequent calls, only provide same signed_block_ptr instance for each invocation.
+      /// only valid for protocol_version >= proto_sync_compression, blocks smaller than min_size are not compressed.
+      const send_buffer_type& get_compressed_send_buffer( const signed_block_ptr& sb, uint32_t min_size ) {
+         if( !compressed_send_buffer ) {
+            if( fc::raw::pack_size( *sb ) < min_size ) {
+               return get_send_buffer( sb, proto_sync_compression );
+            }
+            compressed_send_buffer = create_compressed_send_buffer( sb );
+         }
+         return compressed_send_buffer;
+      }
+
    private:
       send_buffer_type send_buffer_v0;
+      send_buffer_type compact_send_buffer;
+      send_buffer_type compressed_send_buffer;
 
    private:
 
+      static std::shared_ptr<std::vector<char>> create_compressed_send_buffer( const signed_block_ptr& sb ) {
+         static_assert( compressed_block_message_which == fc::get_index<net_message, compressed_block_message>() );
+         compressed_block_message cb{ *sb, static_cast<uint32_t>( fc::raw::pack_size( *sb ) ), compress_block( *sb ) };
+         fc_dlog( logger, "sending compressed block ${bn}, ${c} of ${u} bytes",
+                  ("bn", sb->block_num())("c", cb.data.size())("u", cb.uncompressed_size) );
+         return buffer_factory::create_send_buffer( compressed_block_message_which, cb );
+      }
+
+      static std::shared_ptr<std::vector<char>> create_compact_send_buffer( const signed_block_ptr& sb ) {
+         static_assert( compact_block_message_which == fc::get_index<net_message, compact_block_message>() );
+         compact_block_message cb{ *sb, sb->prune_state, {}, sb->block_extensions };
+         cb.transactions.reserve( sb->transactions.size() );
+         for( const auto& r : sb->transactions ) {
+            compact_trx_receipt cr;
+            static_cast<transaction_receipt_header&>(cr) = r;
+            if( std::holds_alternative<transaction_id_type>( r.trx ) ) {
+               cr.trx = std::get<transaction_id_type>( r.trx );
+            } else {
+               cr.trx = short_trx_id( std::get<packed_transaction>( r.trx ).id() );
+            }
+            cb.transactions.emplace_back( std::move( cr ) );
+         }
+         fc_dlog( logger, "sending compact block ${bn}", ("bn", sb->block_num()) );
+         return buffer_factory::create_send_buffer( compact_block_message_which, cb );
+      }
+
       static std::shared_ptr<std::vector<char>> create_send_buffer( const signed_block_ptr& sb ) {
          static_assert( signed_block_which == fc::get_index<net_message, signed_block>() );
          // this implementation is to avoid copy of signed_block to net_message
@@ -1387,6 +1834,127 @@ namespace eosio {
       }
    };
 
+   /**
+    * LRU of block send buffers shared by all connections, so blocks sent to several peers, in particular when they sync
+    * the same range from us, are only read and packed once. Keyed by block id and block_buffer_kind, limited by
+    * total buffer size. Buffers of irreversible blocks can also be found by block number. Thread safe.
+    */
+   class block_buffer_cache {
+   public:
+      explicit block_buffer_cache( size_t max_bytes ) : max_bytes( max_bytes ) {}
+
+      /// returns the cached buffer or creates and caches it, only provide same factory for the same signed_block_ptr.
+      /// irreversible if sb is known to be an irreversible block of our chain
+      send_buffer_type get_send_buffer( const signed_block_ptr& sb, const block_id_type& id, block_buffer_kind kind,
+                                        block_buffer_factory& factory, bool irreversible = false );
+
+      /// returns nullptr if not cached or not known to be irreversible, does not access the chain
+      send_buffer_type get_irreversible_send_buffer( uint32_t block_num, block_buffer_kind kind );
+
+      /// marks the buffers of id irreversible and drops the buffers of forked out blocks of the same number
+      void on_irreversible_block( const block_id_type& id );
+
+   private:
+      struct entry {
+         block_id_type     id;
+         uint32_t          block_num = 0;
+         block_buffer_kind kind = block_buffer_kind::signed_block;
+         bool              irreversible = false;
+         send_buffer_type  buffer;
+      };
+
+      typedef multi_index_container<
+         entry,
+         indexed_by<
+            sequenced<>, // most recently used first
+            ordered_unique< tag<by_id>,
+               composite_key< entry,
+                  member<entry, block_id_type, &entry::id>,
+                  member<entry, block_buffer_kind, &entry::kind>
+               >,
+               composite_key_compare< sha256_less, std::less<block_buffer_kind> >
+            >,
+            ordered_non_unique< tag<by_block_num>,
+               composite_key< entry,
+                  member<entry, uint32_t, &entry::block_num>,
+                  member<entry, block_buffer_kind, &entry::kind>
+               >
+            >
+         >
+      > entry_index;
+
+      std::mutex   mtx;
+      entry_index  entries;
+      size_t       size_bytes = 0;
+      const size_t max_bytes;
+   };
+
+   send_buffer_type block_buffer_cache::get_send_buffer( const signed_block_ptr& sb, const block_id_type& id, block_buffer_kind kind,
+                                                         block_buffer_factory& factory, bool irreversible ) {
+      auto create = [&]() -> send_buffer_type {
+         switch( kind ) {
+            case block_buffer_kind::signed_block:    return factory.get_send_buffer( sb, proto_pruned_types );
+            case block_buffer_kind::signed_block_v0: return factory.get_send_buffer( sb, proto_base );
+            case block_buffer_kind::compressed:      return factory.get_compressed_send_buffer( sb, my_impl->p2p_sync_compression_min_size );
+         }
+         return {};
+      };
+      if( max_bytes == 0 ) return create();
+
+      std::unique_lock<std::mutex> g( mtx );
+      auto& idx = entries.get<by_id>();
+      auto itr = idx.find( std::make_tuple( std::ref( id ), kind ) );
+      if( itr != idx.end() ) {
+         if( irreversible && !itr->irreversible ) idx.modify( itr, []( entry& e ) { e.irreversible = true; } );
+         entries.relocate( entries.begin(), entries.project<0>( itr ) );
+         return itr->buffer;
+      }
+      g.unlock();
+
+      // pack outside of lock, a concurrent creation of the same buffer is harmless
+      send_buffer_type buffer = create();
+      if( !buffer ) return buffer;
+
+      g.lock();
+      auto r = entries.push_front( entry{id, block_header::num_from_id( id ), kind, irreversible, buffer} );
+      if( r.second ) {
+         size_bytes += buffer->size();
+         while( size_bytes > max_bytes && entries.size() > 1 ) {
+            size_bytes -= entries.back().buffer->size();
+            entries.pop_back();
+         }
+      }
+      return buffer;
+   }
+
+   send_buffer_type block_buffer_cache::get_irreversible_send_buffer( uint32_t block_num, block_buffer_kind kind ) {
+      std::lock_guard<std::mutex> g( mtx );
+      auto& idx = entries.get<by_block_num>();
+      auto range = idx.equal_range( std::make_tuple( block_num, kind ) );
+      for( auto itr = range.first; itr != range.second; ++itr ) {
+         if( itr->irreversible ) {
+            entries.relocate( entries.begin(), entries.project<0>( itr ) );
+            return itr->buffer;
+         }
+      }
+      return {};
+   }
+
+   void block_buffer_cache::on_irreversible_block( const block_id_type& id ) {
+      std::lock_guard<std::mutex> g( mtx );
+      auto& idx = entries.get<by_block_num>();
+      auto range = idx.equal_range( std::make_tuple( block_header::num_from_id( id ) ) );
+      for( auto itr = range.first; itr != range.second; ) {
+         if( itr->id == id ) {
+            idx.modify( itr, []( entry& e ) { e.irreversible = true; } );
+            ++itr;
+         } else {
+            size_bytes -= itr->buffer->size();
+            itr = idx.erase( itr );
+         }
+      }
+   }
+
    struct trx_buffer_factory : public buffer_factory {
 
       /// caches result for subsequent calls, only provide same packed_transaction_ptr instance for each invocation.
@@ -1446,12 +2014,13 @@ namespace eosio {
       enqueue_buffer( send_buffer, close_after_send );
    }
 
-   void connection::enqueue_block( const signed_block_ptr& b, bool to_sync_queue) {
+   void connection::enqueue_block( const signed_block_ptr& b, bool to_sync_queue, bool irreversible ) {
       fc_dlog( logger, "enqueue block ${num}", ("num", b->block_num()) );
       verify_strand_in_this_thread( strand, __func__, __LINE__ );
 
       block_buffer_factory buff_factory;
-      auto sb = buff_factory.get_send_buffer( b, protocol_version.load() );
+      auto sb = my_impl->block_buffers->get_send_buffer( b, b->calculate_id(), block_buffer_kind_for( to_sync_queue ), buff_factory,
+                                                         irreversible );
       if( !sb ) {
          peer_wlog( this, "Sending go away for incomplete block #${n} ${id}...",
                     ("n", b->block_num())("id", b->calculate_id().str().substr(8,16)) );
@@ -1462,6 +2031,60 @@ namespace eosio {
       enqueue_buffer( sb, no_reason, to_sync_queue);
    }
 
+   bool connection::enqueue_sync_block() {
+      if( !peer_requested ) {
+         return false;
+      } else {
+         fc_dlog( logger, "enqueue sync block ${num}", ("num", peer_requested->last + 1) );
+      }
+      uint32_t num = ++peer_requested->last;
+      if(num == peer_requested->end_block) {
+         peer_requested.reset();
+         fc_ilog( logger, "completing enqueue_sync_block ${num} to ${p}", ("num", num)("p", peer_name()) );
+      }
+      connection_wptr weak = shared_from_this();
+      app().post( priority::medium, [num, weak{std::move(weak)}]() {
+         connection_ptr c = weak.lock();
+         if( !c ) return;
+         // avoid reading and packing the block again if recently sent to another peer, only buffers of irreversible
+         // blocks are matched by number so a cached forked out block of the same number is never sent
+         send_buffer_type buffer = my_impl->block_buffers->get_irreversible_send_buffer( num, c->block_buffer_kind_for( true ) );
+         if( buffer ) {
+            c->strand.post( [c, buffer{std::move(buffer)}]() {
+               c->enqueue_buffer( buffer, no_reason, true );
+            });
+            return;
+         }
+         controller& cc = my_impl->chain_plug->chain();
+         signed_block_ptr sb;
+         bool irreversible = false;
+         try {
+            sb = cc.fetch_block_by_number( num );
+            irreversible = num <= cc.last_irreversible_block_num();
+         } FC_LOG_AND_DROP();
+         if( sb ) {
+            c->strand.post( [c, sb{std::move(sb)}, irreversible]() {
+               c->enqueue_block( sb, true, irreversible );
+            });
+         } else {
+            c->strand.post( [c, num]() {
+               peer_ilog( c, "enqueue sync, unable to fetch block ${num}", ("num", num) );
+               c->send_handshake();
+            });
+         }
+      });
+
+      return true;
+   }
+
+   // thread safe
+   block_buffer_kind connection::block_buffer_kind_for( bool to_sync_queue ) const {
+      const uint16_t peer_protocol_version = protocol_version.load();
+      if( to_sync_queue && peer_protocol_version >= proto_sync_compression && peer_accepts_compressed_blocks )
+         return block_buffer_kind::compressed;
+      return peer_protocol_version >= proto_pruned_types ? block_buffer_kind::signed_block : block_buffer_kind::signed_block_v0;
+   }
+
    void connection::enqueue_buffer( const std::shared_ptr<std::vector<char>>& send_buffer,
                                     go_away_reason close_after_send,
                                     bool to_sync_queue)
@@ -1548,9 +2171,25 @@ namespace eosio {
    void connection::request_sync_blocks(uint32_t start, uint32_t end) {
       sync_request_message srm = {start,end};
       enqueue( net_message(srm) );
+      last_sync_block_time = fc::time_point::now();
       sync_wait();
    }
 
+   // called from connection strand
+   void connection::record_sync_block_arrival() {
+      const auto now = fc::time_point::now();
+      if( last_sync_block_time != fc::time_point() ) {
+         const int64_t interval = (now - last_sync_block_time).count();
+         const int64_t prev = sync_block_interval_us;
+         sync_block_interval_us = prev == 0 ? interval : (prev * 7 + interval) / 8;
+      }
+      last_sync_block_time = now;
+   }
+
+   int64_t connection::sync_score( uint32_t span ) const {
+      return eosio::sync_score( sync_block_interval_us, rtt_us, sync_failures, span );
+   }
+
    //-----------------------------------------------------------
    void block_status_monitor::reset() {
       in_accepted_state_ = true;
@@ -1578,11 +2217,12 @@ namespace eosio {
    }
    //-----------------------------------------------------------
 
-    sync_manager::sync_manager( uint32_t req_span )
+    sync_manager::sync_manager( uint32_t req_span, uint32_t max_sources )
       :sync_known_lib_num( 0 )
       ,sync_last_requested_num( 0 )
       ,sync_next_expected_num( 1 )
       ,sync_req_span( req_span )
+      ,sync_max_sources( max_sources )
       ,sync_source()
       ,sync_state(in_sync)
    {
@@ -1603,9 +2243,31 @@ namespace eosio {
       }
       fc_ilog( logger, "old state ${os} becoming ${ns}", ("os", stage_str( sync_state ))( "ns", stage_str( newstate ) ) );
       sync_state = newstate;
+      if( newstate != lib_catchup ) {
+         reset_sync_reorder();
+      }
       return true;
    }
 
+   // call with g_sync locked
+   void sync_manager::reset_sync_chunks() {
+      sync_last_requested_num = 0;
+      sync_chunks.clear();
+      reset_sync_reorder();
+   }
+
+   // call with g_sync locked, blocks from sync_next_expected_num on are requested again so must pass the reorder buffer again
+   void sync_manager::reset_sync_reorder() {
+      sync_reorder_buffer.clear();
+      sync_next_dispatch_num = sync_next_expected_num;
+   }
+
+   // call with g_sync locked
+   bool sync_manager::is_sync_source( const connection_ptr& c ) const {
+      if( c == sync_source ) return true;
+      return std::any_of( sync_chunks.begin(), sync_chunks.end(), [&c]( const auto& chunk ) { return chunk.source == c; } );
+   }
+
    void sync_manager::sync_reset_lib_num(const connection_ptr& c) {
       std::unique_lock<std::mutex> g( sync_mtx );
       if( sync_state == in_sync ) {
@@ -1617,8 +2279,8 @@ namespace eosio {
          if( c->last_handshake_recv.last_irreversible_block_num > sync_known_lib_num ) {
             sync_known_lib_num = c->last_handshake_recv.last_irreversible_block_num;
          }
-      } else if( c == sync_source ) {
-         sync_last_requested_num = 0;
+      } else if( is_sync_source( c ) ) {
+         reset_sync_chunks();
          request_next_chunk( std::move(g) );
       }
    }
@@ -1633,7 +2295,15 @@ namespace eosio {
       fc_dlog( logger, "sync_last_requested_num: ${r}, sync_next_expected_num: ${e}, sync_known_lib_num: ${k}, sync_req_span: ${s}",
                ("r", sync_last_requested_num)("e", sync_next_expected_num)("k", sync_known_lib_num)("s", sync_req_span) );
 
-      if( fork_head_block_num < sync_last_requested_num && sync_source && sync_source->current() ) {
+      // chunks are complete once applied
+      while( !sync_chunks.empty() && sync_chunks.front().end <= fork_head_block_num ) {
+         if( const auto& source = sync_chunks.front().source ) {
+            source->sync_failures = source->sync_failures / 2;
+         }
+         sync_chunks.pop_front();
+      }
+
+      if( sync_chunks.size() >= sync_max_sources && sync_source && sync_source->current() ) {
          fc_ilog( logger, "ignoring request, head is ${h} last req = ${r} source is ${p}",
                   ("h", fork_head_block_num)( "r", sync_last_requested_num )( "p", sync_source->peer_name() ) );
          return;
@@ -1642,90 +2312,107 @@ namespace eosio {
       /* ----------
        * next chunk provider selection criteria
        * a provider is supplied and able to be used, use it.
-       * otherwise select the next available from the list, round-robin style.
+       * otherwise select the fastest available peer, see advance_sync_source.
        */
 
       if (conn && conn->current() ) {
          sync_source = conn;
       } else {
-         std::shared_lock<std::shared_mutex> g( my_impl->connections_mtx );
-         if( my_impl->connections.size() == 0 ) {
-            sync_source.reset();
-         } else if( my_impl->connections.size() == 1 ) {
-            if (!sync_source) {
-               sync_source = *my_impl->connections.begin();
-            }
-         } else {
-            // init to a linear array search
-            auto cptr = my_impl->connections.begin();
-            auto cend = my_impl->connections.end();
-            // do we remember the previous source?
-            if (sync_source) {
-               //try to find it in the list
-               cptr = my_impl->connections.find( sync_source );
-               cend = cptr;
-               if( cptr == my_impl->connections.end() ) {
-                  //not there - must have been closed! cend is now connections.end, so just flatten the ring.
-                  sync_source.reset();
-                  cptr = my_impl->connections.begin();
-               } else {
-                  //was found - advance the start to the next. cend is the old source.
-                  if( ++cptr == my_impl->connections.end() && cend != my_impl->connections.end() ) {
-                     cptr = my_impl->connections.begin();
-                  }
-               }
-            }
-
-            //scan the list of peers looking for another able to provide sync blocks.
-            if( cptr != my_impl->connections.end() ) {
-               auto cstart_it = cptr;
-               do {
-                  //select the first one which is current and break out.
-                  if( !(*cptr)->is_transactions_only_connection() && (*cptr)->current() ) {
-                     sync_source = *cptr;
-                     break;
-                  }
-                  if( ++cptr == my_impl->connections.end() )
-                     cptr = my_impl->connections.begin();
-               } while( cptr != cstart_it );
-            }
-            // no need to check the result, either source advanced or the whole list was checked and the old source is reused.
-         }
+         advance_sync_source();
       }
 
       // verify there is an available source
       if( !sync_source || !sync_source->current() || sync_source->is_transactions_only_connection() ) {
          fc_elog( logger, "Unable to continue syncing at this time");
          sync_known_lib_num = lib_block_num;
-         sync_last_requested_num = 0;
+         reset_sync_chunks();
          set_state( in_sync ); // probably not, but we can't do anything else
          return;
       }
 
-      bool request_sent = false;
-      if( sync_last_requested_num != sync_known_lib_num ) {
-         uint32_t start = sync_next_expected_num;
+      // with sync_max_sources > 1 keep up to that many chunks in flight, each from a different peer
+      std::vector<sync_chunk> requests;
+      while( sync_chunks.size() < sync_max_sources && sync_last_requested_num != sync_known_lib_num ) {
+         uint32_t start = sync_chunks.empty() ? sync_next_expected_num : sync_chunks.back().end + 1;
          uint32_t end = start + sync_req_span - 1;
          if( end > sync_known_lib_num )
             end = sync_known_lib_num;
-         if( end > 0 && end >= start ) {
-            sync_last_requested_num = end;
-            connection_ptr c = sync_source;
-            g_sync.unlock();
-            request_sent = true;
-            c->strand.post( [c, start, end]() {
+         if( end == 0 || end < start )
+            break;
+         sync_last_requested_num = end;
+         sync_chunks.push_back( sync_chunk{start, end, sync_source} );
+         requests.push_back( sync_chunks.back() );
+
+         if( sync_chunks.size() < sync_max_sources ) {
+            advance_sync_source();
+            if( !sync_source || !sync_source->current() || sync_source->is_transactions_only_connection() ||
+                std::any_of( sync_chunks.begin(), sync_chunks.end(), [this]( const auto& chunk ) { return chunk.source == sync_source; } ) ) {
+               // no additional peer available
+               sync_source = sync_chunks.back().source;
+               break;
+            }
+         }
+      }
+
+      if( !requests.empty() ) {
+         g_sync.unlock();
+         for( auto& r : requests ) {
+            r.source->strand.post( [c = r.source, start = r.start, end = r.end]() {
                fc_ilog( logger, "requesting range ${s} to ${e}, from ${n}", ("n", c->peer_name())( "s", start )( "e", end ) );
                c->request_sync_blocks( start, end );
             } );
          }
-      }
-      if( !request_sent ) {
+      } else {
          connection_ptr c = sync_source;
          g_sync.unlock();
          c->send_handshake();
       }
    }
 
+   // call with g_sync locked, selects the peer able to provide sync blocks with the lowest sync_score that is not
+   // already the source of an outstanding chunk. Peers not yet measured score 0 so each is tried and measured, unless
+   // they already failed. Ties go to the next peer after sync_source, round-robin style. If no other peer is available
+   // sync_source is kept.
+   void sync_manager::advance_sync_source() {
+      std::shared_lock<std::shared_mutex> g( my_impl->connections_mtx );
+      if( my_impl->connections.size() == 0 ) {
+         sync_source.reset();
+         return;
+      }
+      if( my_impl->connections.size() == 1 ) {
+         if (!sync_source) {
+            sync_source = *my_impl->connections.begin();
+         }
+         return;
+      }
+
+      // start the scan after the previous source, if it is still connected
+      auto cstart = my_impl->connections.begin();
+      if( sync_source ) {
+         auto itr = my_impl->connections.find( sync_source );
+         if( itr == my_impl->connections.end() ) {
+            sync_source.reset();
+         } else if( ++itr != my_impl->connections.end() ) {
+            cstart = itr;
+         }
+      }
+
+      auto best = select_sync_source( my_impl->connections.begin(), my_impl->connections.end(), cstart,
+                                      [this]( const connection_ptr& c ) -> std::optional<int64_t> {
+         if( c->is_transactions_only_connection() || !c->current() ||
+             std::any_of( sync_chunks.begin(), sync_chunks.end(), [&c]( const auto& chunk ) { return chunk.source == c; } ) )
+            return {};
+         return c->sync_score( sync_req_span );
+      } );
+
+      if( best != my_impl->connections.end() ) {
+         if( *best != sync_source ) {
+            fc_dlog( logger, "selected sync source ${p}, score ${s}us", ("p", (*best)->peer_name())("s", (*best)->sync_score( sync_req_span )) );
+         }
+         sync_source = *best;
+      }
+   }
+
    // static, thread safe
    void sync_manager::send_handshakes() {
       for_each_connection( []( auto& ci ) {
@@ -1779,9 +2466,10 @@ namespace eosio {
       fc_ilog( logger, "reassign_fetch, our last req is ${cc}, next expected is ${ne} peer ${p}",
                ("cc", sync_last_requested_num)( "ne", sync_next_expected_num )( "p", c->peer_name() ) );
 
-      if( c == sync_source ) {
+      if( is_sync_source( c ) ) {
+         ++c->sync_failures;
          c->cancel_sync(reason);
-         sync_last_requested_num = 0;
+         reset_sync_chunks();
          request_next_chunk( std::move(g) );
       }
    }
@@ -1965,10 +2653,11 @@ namespace eosio {
    // called from connection strand
    void sync_manager::rejected_block( const connection_ptr& c, uint32_t blk_num ) {
       c->block_status_monitor_.rejected();
+      ++c->sync_failures;
       if( c->block_status_monitor_.max_events_violated()) {
          fc_wlog( logger, "block ${bn} not accepted from ${p}, closing connection", ("bn", blk_num)("p", c->peer_name()) );
          std::unique_lock<std::mutex> g( sync_mtx );
-         sync_last_requested_num = 0;
+         reset_sync_chunks();
          sync_source.reset();
          g.unlock();
          c->close();
@@ -1977,6 +2666,36 @@ namespace eosio {
       }
    }
 
+   // called from main thread when a block dispatched by the reorder buffer is rejected, the blocks dispatched after it
+   // can not link, drop them without blaming their sources and request them again
+   void sync_manager::rejected_reordered_block( uint32_t blk_num ) {
+      std::unique_lock<std::mutex> g( sync_mtx );
+      ++sync_dispatch_generation;
+      if( sync_state == lib_catchup && blk_num < sync_next_dispatch_num ) {
+         reset_sync_chunks();
+         request_next_chunk( std::move( g ) );
+      }
+   }
+
+   // called from connection strand when a buffered block of c fails its transaction merkle root check
+   void sync_manager::sync_invalid_block( const connection_ptr& c, uint32_t blk_num ) {
+      peer_elog( c, "invalid transaction merkle root in sync block ${n}, closing", ("n", blk_num) );
+      ++c->sync_failures;
+      {
+         std::lock_guard<std::mutex> g( sync_mtx );
+         reset_sync_chunks();
+         if( sync_source == c ) sync_source.reset();
+      }
+      c->close();
+      // after the close on the same strand, so c is not selected again: request the dropped block right away
+      // instead of waiting for its chunk to time out
+      c->strand.post( [this]() {
+         std::unique_lock<std::mutex> g( sync_mtx );
+         if( sync_state == lib_catchup && sync_chunks.empty() )
+            request_next_chunk( std::move( g ) );
+      } );
+   }
+
    // called from connection strand
    void sync_manager::sync_update_expected( const connection_ptr& c, const block_id_type& blk_id, uint32_t blk_num, bool blk_applied ) {
       std::unique_lock<std::mutex> g_sync( sync_mtx );
@@ -2044,7 +2763,7 @@ namespace eosio {
             set_state( in_sync );
             g_sync.unlock();
             send_handshakes();
-         } else if( blk_num == sync_last_requested_num ) {
+         } else if( blk_num == sync_last_requested_num || (!sync_chunks.empty() && blk_num == sync_chunks.front().end) ) {
             request_next_chunk( std::move( g_sync) );
          } else {
             g_sync.unlock();
@@ -2054,6 +2773,77 @@ namespace eosio {
       }
    }
 
+   // called from connection strand
+   // When fetching from multiple peers, chunks arrive in any order. Blocks ahead of the next block to apply are held
+   // in a window of sync_req_span * sync_max_sources blocks and handed to the main thread in order once their
+   // predecessors arrive. Returns true if the block was taken, false if it should be processed as usual.
+   bool sync_manager::sync_reorder_block( const connection_ptr& c, const block_id_type& blk_id, const signed_block_ptr& ptr ) {
+      if( sync_max_sources <= 1 || sync_state != lib_catchup )
+         return false;
+
+      const uint32_t blk_num = ptr->block_num();
+      std::unique_lock<std::mutex> g_sync( sync_mtx );
+      sync_next_dispatch_num = std::max( sync_next_dispatch_num, sync_next_expected_num );
+      if( blk_num < sync_next_dispatch_num )
+         return false;
+
+      if( blk_num == sync_next_dispatch_num ) {
+         dispatch_sync_block( pending_sync_block{blk_id, ptr, c} );
+         for( auto itr = sync_reorder_buffer.begin();
+              itr != sync_reorder_buffer.end() && itr->first == sync_next_dispatch_num;
+              itr = sync_reorder_buffer.erase( itr ) ) {
+            dispatch_sync_block( std::move( itr->second ) );
+         }
+         return true;
+      }
+
+      if( blk_num - sync_next_dispatch_num >= sync_req_span * sync_max_sources ) {
+         fc_dlog( logger, "dropping sync block ${n} from ${p}, outside of window starting at ${d}",
+                  ("n", blk_num)("p", c->peer_name())("d", sync_next_dispatch_num) );
+         return true;
+      }
+
+      if( !sync_reorder_buffer.emplace( blk_num, pending_sync_block{blk_id, ptr, c} ).second )
+         return true; // duplicate
+      g_sync.unlock();
+
+      // validate transaction merkle root on the thread pool while the block waits, so a bad peer is found before
+      // the main thread reaches the block. Signatures are validated by the controller on the chain thread pool.
+      boost::asio::post( my_impl->thread_pool->get_executor(), [sync_master = this, c, blk_num, ptr]() {
+         deque<digest_type> trx_digests;
+         for( const auto& r : ptr->transactions )
+            trx_digests.emplace_back( r.digest() );
+         if( merkle( std::move( trx_digests ) ) == ptr->transaction_mroot )
+            return;
+         std::unique_lock<std::mutex> g_sync( sync_master->sync_mtx );
+         auto itr = sync_master->sync_reorder_buffer.find( blk_num );
+         if( itr != sync_master->sync_reorder_buffer.end() && itr->second.block == ptr ) {
+            sync_master->sync_reorder_buffer.erase( itr );
+         }
+         g_sync.unlock();
+         c->strand.post( [sync_master, c, blk_num]() {
+            sync_master->sync_invalid_block( c, blk_num );
+         } );
+      } );
+
+      // the source is still making progress even though its blocks can not be applied yet
+      c->sync_wait();
+      return true;
+   }
+
+   // call with g_sync locked, posting while locked keeps blocks in order on the main thread
+   void sync_manager::dispatch_sync_block( pending_sync_block&& pending ) {
+      ++sync_next_dispatch_num;
+      pending.generation = sync_dispatch_generation;
+      app().post( priority::medium, [sync_master = this, pending{std::move(pending)}]() mutable {
+         if( sync_master->is_stale_dispatch( pending.generation ) ) {
+            fc_dlog( logger, "dropping sync block ${n} dispatched after a rejected block", ("n", pending.block->block_num()) );
+            return;
+         }
+         pending.source->process_signed_block( pending.id, std::move( pending.block ), true );
+      } );
+   }
+
    //------------------------------------------------------------------------
 
    // thread safe
@@ -2068,105 +2858,169 @@ namespace eosio {
             pb.have_block = true;
          });
       }
-      return added;
+      return added;
+   }
+
+   bool dispatch_manager::peer_has_block( const block_id_type& blkid, uint32_t connection_id ) const {
+      std::lock_guard<std::mutex> g(blk_state_mtx);
+      const auto blk_itr = blk_state.get<by_id>().find( std::make_tuple( connection_id, std::ref( blkid )));
+      return blk_itr != blk_state.end();
+   }
+
+   bool dispatch_manager::have_block( const block_id_type& blkid ) const {
+      std::lock_guard<std::mutex> g(blk_state_mtx);
+      // by_peer_block_id sorts have_block by greater so have_block == true will be the first one found
+      const auto& index = blk_state.get<by_peer_block_id>();
+      auto blk_itr = index.find( blkid );
+      if( blk_itr != index.end() ) {
+         return blk_itr->have_block;
+      }
+      return false;
+   }
+
+   bool node_transaction_table::add( const node_transaction_state& nts, const packed_transaction_ptr& trx ) {
+      auto& sh = shard_for( nts.id );
+      std::lock_guard<std::mutex> g( sh.mtx );
+      auto tptr = sh.txns.find( nts.id );
+      if( tptr == sh.txns.end() ) {
+         tptr = sh.txns.insert( txn_entry{nts.id, nts.expires, nts.block_num} ).first;
+      }
+      if( trx && !tptr->trx ) {
+         tptr->trx = trx;
+      }
+      return tptr->connection_ids.insert( nts.connection_id ).second;
+   }
+
+   bool node_transaction_table::add_if_known( const transaction_id_type& id, uint32_t connection_id ) {
+      auto& sh = shard_for( id );
+      std::lock_guard<std::mutex> g( sh.mtx );
+      auto tptr = sh.txns.find( id );
+      if( tptr == sh.txns.end() ) return false;
+      tptr->connection_ids.insert( connection_id );
+      return true;
+   }
+
+   void node_transaction_table::update_block_num( const transaction_id_type& id, uint32_t block_num ) {
+      auto& sh = shard_for( id );
+      std::lock_guard<std::mutex> g( sh.mtx );
+      auto tptr = sh.txns.find( id );
+      if( tptr != sh.txns.end() ) {
+         sh.txns.modify( tptr, [block_num]( txn_entry& e ) { e.block_num = block_num; } );
+      }
+   }
+
+   bool node_transaction_table::peer_has( const transaction_id_type& id, uint32_t connection_id ) const {
+      const auto& sh = shard_for( id );
+      std::lock_guard<std::mutex> g( sh.mtx );
+      const auto tptr = sh.txns.find( id );
+      return tptr != sh.txns.end() && tptr->connection_ids.count( connection_id ) > 0;
+   }
+
+   bool node_transaction_table::has( const transaction_id_type& id ) const {
+      const auto& sh = shard_for( id );
+      std::lock_guard<std::mutex> g( sh.mtx );
+      return sh.txns.find( id ) != sh.txns.end();
+   }
+
+   packed_transaction_ptr node_transaction_table::get_trx( short_trx_id_type short_id ) const {
+      const auto& sh = shard_for( short_id );
+      std::lock_guard<std::mutex> g( sh.mtx );
+      auto range = sh.txns.get<by_short_id>().equal_range( short_id );
+      for( auto itr = range.first; itr != range.second; ++itr ) {
+         if( itr->trx ) return itr->trx;
+      }
+      return {};
+   }
+
+   size_t node_transaction_table::expire( uint32_t lib_num, const time_point_sec& now ) {
+      size_t removed = 0;
+      for( auto& sh : shards ) {
+         // only one shard is locked at a time so other threads can continue to use the rest of the table
+         std::lock_guard<std::mutex> g( sh.mtx );
+         const size_t start_size = sh.txns.size();
+         auto& old = sh.txns.get<by_expiry>();
+         old.erase( old.lower_bound( fc::time_point_sec( 0 ) ), old.upper_bound( now ) );
+         auto& stale = sh.txns.get<by_block_num>();
+         stale.erase( stale.lower_bound( 1 ), stale.upper_bound( lib_num ) );
+         removed += start_size - sh.txns.size();
+      }
+      return removed;
+   }
+
+   size_t node_transaction_table::size() const {
+      size_t sz = 0;
+      for( const auto& sh : shards ) {
+         std::lock_guard<std::mutex> g( sh.mtx );
+         sz += sh.txns.size();
+      }
+      return sz;
    }
 
-   bool dispatch_manager::peer_has_block( const block_id_type& blkid, uint32_t connection_id ) const {
-      std::lock_guard<std::mutex> g(blk_state_mtx);
-      const auto blk_itr = blk_state.get<by_id>().find( std::make_tuple( connection_id, std::ref( blkid )));
-      return blk_itr != blk_state.end();
+   transaction_metadata_ptr recovered_keys_cache::get( const digest_type& digest, const packed_transaction_ptr& trx ) const {
+      const vector<signature_type>* sigs = trx->get_signatures();
+      if( !sigs ) return transaction_metadata_ptr();
+      std::lock_guard<std::mutex> g( mtx );
+      const auto& idx = entries.get<by_id>();
+      auto itr = idx.find( digest );
+      if( itr == idx.end() || itr->signatures != *sigs ) return transaction_metadata_ptr();
+      return transaction_metadata::create_recovered_keys( trx, itr->sig_cpu_usage, itr->recovered_keys );
    }
 
-   bool dispatch_manager::have_block( const block_id_type& blkid ) const {
-      std::lock_guard<std::mutex> g(blk_state_mtx);
-      // by_peer_block_id sorts have_block by greater so have_block == true will be the first one found
-      const auto& index = blk_state.get<by_peer_block_id>();
-      auto blk_itr = index.find( blkid );
-      if( blk_itr != index.end() ) {
-         return blk_itr->have_block;
+   void recovered_keys_cache::add( const digest_type& digest, const transaction_metadata_ptr& trx_meta ) {
+      if( max_entries == 0 ) return;
+      const vector<signature_type>* sigs = trx_meta->packed_trx()->get_signatures();
+      if( !sigs ) return;
+      std::lock_guard<std::mutex> g( mtx );
+      auto r = entries.push_back( entry{ digest, *sigs, trx_meta->signature_cpu_usage(), trx_meta->recovered_keys() } );
+      if( !r.second ) { // same digest, possibly different signatures, keep the latest
+         entries.replace( r.first, entry{ digest, *sigs, trx_meta->signature_cpu_usage(), trx_meta->recovered_keys() } );
+         entries.relocate( entries.end(), r.first );
+      }
+      while( entries.size() > max_entries ) {
+         entries.pop_front();
       }
-      return false;
    }
 
-   bool dispatch_manager::add_peer_txn( const node_transaction_state& nts ) {
-      std::lock_guard<std::mutex> g( local_txns_mtx );
-      auto tptr = local_txns.get<by_id>().find( std::make_tuple( std::ref( nts.id ), nts.connection_id ) );
-      bool added = (tptr == local_txns.end());
-      if( added ) {
-         local_txns.insert( nts );
-      }
-      return added;
+   bool dispatch_manager::add_peer_txn( const node_transaction_state& nts, const packed_transaction_ptr& trx ) {
+      return local_txns.add( nts, trx );
    }
 
    // only adds if tid already exists, returns have_txn( tid )
    bool dispatch_manager::add_peer_txn( const transaction_id_type& tid, uint32_t connection_id ) {
-      std::lock_guard<std::mutex> g( local_txns_mtx );
-      auto tptr = local_txns.get<by_id>().find( tid );
-      if( tptr == local_txns.end() ) return false;
-      const auto expiration = tptr->expires;
-
-      tptr = local_txns.get<by_id>().find( std::make_tuple( std::ref( tid ), connection_id ) );
-      if( tptr == local_txns.end() ) {
-         local_txns.insert( node_transaction_state{tid, expiration, 0, connection_id} );
-      }
-      return true;
+      return local_txns.add_if_known( tid, connection_id );
    }
 
 
    // thread safe
    void dispatch_manager::update_txns_block_num( const signed_block_ptr& sb ) {
-      update_block_num ubn( sb->block_num() );
-      std::lock_guard<std::mutex> g( local_txns_mtx );
+      const auto blk_num = sb->block_num();
       for( const auto& recpt : sb->transactions ) {
          const transaction_id_type& id = (recpt.trx.index() == 0) ? std::get<transaction_id_type>(recpt.trx)
                                                                   : std::get<packed_transaction>(recpt.trx).id();
-         auto range = local_txns.get<by_id>().equal_range( id );
-         for( auto itr = range.first; itr != range.second; ++itr ) {
-            local_txns.modify( itr, ubn );
-         }
+         local_txns.update_block_num( id, blk_num );
       }
    }
 
    // thread safe
    void dispatch_manager::update_txns_block_num( const transaction_id_type& id, uint32_t blk_num ) {
-      update_block_num ubn( blk_num );
-      std::lock_guard<std::mutex> g( local_txns_mtx );
-      auto range = local_txns.get<by_id>().equal_range( id );
-      for( auto itr = range.first; itr != range.second; ++itr ) {
-         local_txns.modify( itr, ubn );
-      }
+      local_txns.update_block_num( id, blk_num );
    }
 
    bool dispatch_manager::peer_has_txn( const transaction_id_type& tid, uint32_t connection_id ) const {
-      std::lock_guard<std::mutex> g( local_txns_mtx );
-      const auto tptr = local_txns.get<by_id>().find( std::make_tuple( std::ref( tid ), connection_id ) );
-      return tptr != local_txns.end();
+      return local_txns.peer_has( tid, connection_id );
    }
 
    bool dispatch_manager::have_txn( const transaction_id_type& tid ) const {
-      std::lock_guard<std::mutex> g( local_txns_mtx );
-      const auto tptr = local_txns.get<by_id>().find( tid );
-      return tptr != local_txns.end();
+      return local_txns.has( tid );
    }
 
-   void dispatch_manager::expire_txns( uint32_t lib_num ) {
-      size_t start_size = 0, end_size = 0;
-
-      std::unique_lock<std::mutex> g( local_txns_mtx );
-      start_size = local_txns.size();
-      auto& old = local_txns.get<by_expiry>();
-      auto ex_lo = old.lower_bound( fc::time_point_sec( 0 ) );
-      auto ex_up = old.upper_bound( time_point::now() );
-      old.erase( ex_lo, ex_up );
-      g.unlock(); // allow other threads opportunity to use local_txns
-
-      g.lock();
-      auto& stale = local_txns.get<by_block_num>();
-      stale.erase( stale.lower_bound( 1 ), stale.upper_bound( lib_num ) );
-      end_size = local_txns.size();
-      g.unlock();
+   packed_transaction_ptr dispatch_manager::get_txn( short_trx_id_type short_id ) const {
+      return local_txns.get_trx( short_id );
+   }
 
-      fc_dlog( logger, "expire_local_txns size ${s} removed ${r}", ("s", start_size)( "r", start_size - end_size ) );
+   void dispatch_manager::expire_txns( uint32_t lib_num ) {
+      const size_t removed = local_txns.expire( lib_num, time_point::now() );
+      fc_dlog( logger, "expire_local_txns size ${s} removed ${r}", ("s", local_txns.size())( "r", removed ) );
    }
 
    void dispatch_manager::expire_blocks( uint32_t lib_num ) {
@@ -2183,11 +3037,17 @@ namespace eosio {
 
       block_buffer_factory buff_factory;
       const auto bnum = b->block_num();
+      // cache for peers that later request or sync this block, even if all current peers are sent compact blocks
+      my_impl->block_buffers->get_send_buffer( b, id, block_buffer_kind::signed_block, buff_factory );
       for_each_block_connection( [this, &id, &bnum, &b, &buff_factory]( auto& cp ) {
          peer_dlog( cp, "socket_is_open ${s}, connecting ${c}, syncing ${ss}",
                     ("s", cp->socket_is_open())("c", cp->connecting.load())("ss", cp->syncing.load()) );
          if( !cp->current() ) return true;
-         send_buffer_type sb = buff_factory.get_send_buffer( b, cp->protocol_version.load() );
+         // blocks only peers do not receive transactions from us, so are unlikely to be able to reconstruct a compact block
+         const uint16_t protocol_version = cp->protocol_version.load();
+         const bool compact = protocol_version >= proto_compact_blocks && !cp->is_blocks_only_connection();
+         send_buffer_type sb = compact ? buff_factory.get_compact_send_buffer( b )
+                                       : my_impl->block_buffers->get_send_buffer( b, id, cp->block_buffer_kind_for( false ), buff_factory );
          if( !sb ) {
             peer_wlog( cp, "Sending go away for incomplete block #${n} ${id}...",
                        ("n", b->block_num())("id", b->calculate_id().str().substr(8,16)) );
@@ -2196,7 +3056,7 @@ namespace eosio {
             return true;
          }
 
-         cp->strand.post( [this, cp, id, bnum, sb{std::move(sb)}]() {
+         cp->strand.post( [this, cp, id, bnum, b, compact, sb{std::move(sb)}]() {
             std::unique_lock<std::mutex> g_conn( cp->conn_mtx );
             bool has_block = cp->last_handshake_recv.last_irreversible_block_num >= bnum;
             g_conn.unlock();
@@ -2207,6 +3067,7 @@ namespace eosio {
                }
                fc_dlog( logger, "bcast block ${b} to ${p}", ("b", bnum)("p", cp->peer_name()) );
                cp->enqueue_buffer( sb, no_reason );
+               if( compact ) cp->add_sent_compact( id, b );
             }
          });
          return true;
@@ -2245,7 +3106,7 @@ namespace eosio {
             return true;
          }
          nts.connection_id = cp->connection_id;
-         if( !add_peer_txn(nts) ) {
+         if( !add_peer_txn(nts, trx) ) {
             return true;
          }
 
@@ -2369,12 +3230,26 @@ namespace eosio {
       }
 
       strand.post([c]() {
+         c->set_connection_type( c->peer_address() );
+         if( is_local_peer_address( c->peer_address() ) ) {
+            local::stream_protocol::endpoint endpoint;
+            try {
+               endpoint = local::stream_protocol::endpoint( local_socket_path( c->peer_address() ) );
+            } catch( const std::exception& e ) {
+               fc_elog( logger, "Invalid unix socket address ${add}: ${error}", ("add", c->peer_name())( "error", e.what() ) );
+               c->connecting = false;
+               c->no_retry = fatal_other;
+               return;
+            }
+            c->connect( endpoint );
+            return;
+         }
+
          string::size_type colon = c->peer_address().find(':');
          string::size_type colon2 = c->peer_address().find(':', colon + 1);
          string host = c->peer_address().substr( 0, colon );
          string port = c->peer_address().substr( colon + 1, colon2 == string::npos ? string::npos : colon2 - (colon + 1));
          idump((host)(port));
-         c->set_connection_type( c->peer_address() );
 
          auto resolver = std::make_shared<tcp::resolver>( my_impl->thread_pool->get_executor() );
          connection_wptr weak_conn = c;
@@ -2396,48 +3271,69 @@ namespace eosio {
    }
 
    // called from connection strand
-   void connection::connect( const std::shared_ptr<tcp::resolver>& resolver, tcp::resolver::results_type endpoints ) {
+   bool connection::prepare_connect() {
       switch ( no_retry ) {
          case no_reason:
          case wrong_version:
          case benign_other:
             break;
          default:
-            return;
+            return false;
       }
       connecting = true;
       pending_message_buffer.reset();
       buffer_queue.clear_out_queue();
+      return true;
+   }
+
+   // called from connection strand
+   void connection::on_connect( const boost::system::error_code& err, const std::shared_ptr<stream_socket>& socket ) {
+      if( !err && socket->is_open() && socket == this->socket ) {
+         if( start_session() ) {
+            send_handshake();
+         }
+      } else {
+         fc_elog( logger, "connection failed to ${peer}: ${error}", ("peer", peer_name())( "error", err.message()));
+         close( false );
+      }
+   }
+
+   // called from connection strand
+   void connection::connect( const std::shared_ptr<tcp::resolver>& resolver, tcp::resolver::results_type endpoints ) {
+      if( !prepare_connect() ) return;
       boost::asio::async_connect( *socket, endpoints,
          boost::asio::bind_executor( strand,
-               [resolver, c = shared_from_this(), socket=socket]( const boost::system::error_code& err, const tcp::endpoint& endpoint ) {
-            if( !err && socket->is_open() && socket == c->socket ) {
-               if( c->start_session() ) {
-                  c->send_handshake();
-               }
-            } else {
-               fc_elog( logger, "connection failed to ${peer}: ${error}", ("peer", c->peer_name())( "error", err.message()));
-               c->close( false );
-            }
+               [resolver, c = shared_from_this(), socket=socket]( const boost::system::error_code& err, const auto& endpoint ) {
+            c->on_connect( err, socket );
+      } ) );
+   }
+
+   // called from connection strand
+   void connection::connect( const local::stream_protocol::endpoint& endpoint ) {
+      if( !prepare_connect() ) return;
+      socket->async_connect( endpoint,
+         boost::asio::bind_executor( strand, [c = shared_from_this(), socket=socket]( const boost::system::error_code& err ) {
+            c->on_connect( err, socket );
       } ) );
    }
 
-   void net_plugin_impl::start_listen_loop() {
+   template<typename Acceptor>
+   void net_plugin_impl::start_listen_loop( Acceptor& acc ) {
       connection_ptr new_connection = std::make_shared<connection>();
       new_connection->connecting = true;
-      new_connection->strand.post( [this, new_connection = std::move( new_connection )](){
-         acceptor->async_accept( *new_connection->socket,
-            boost::asio::bind_executor( new_connection->strand, [new_connection, socket=new_connection->socket, this]( boost::system::error_code ec ) {
+      new_connection->strand.post( [this, &acc, new_connection = std::move( new_connection )](){
+         acc.async_accept( *new_connection->socket,
+            boost::asio::bind_executor( new_connection->strand, [new_connection, socket=new_connection->socket, this, &acc]( boost::system::error_code ec ) {
             if( !ec ) {
                uint32_t visitors = 0;
                uint32_t from_addr = 0;
                boost::system::error_code rec;
-               const auto& paddr_add = socket->remote_endpoint( rec ).address();
+               const auto paddr = socket->remote_endpoint( rec );
                string paddr_str;
                if( rec ) {
                   fc_elog( logger, "Error getting remote endpoint: ${m}", ("m", rec.message()));
                } else {
-                  paddr_str = paddr_add.to_string();
+                  paddr_str = to_address_port( paddr ).first;
                   for_each_connection( [&visitors, &from_addr, &paddr_str]( auto& conn ) {
                      if( conn->socket_is_open()) {
                         if( conn->peer_address().empty()) {
@@ -2450,7 +3346,9 @@ namespace eosio {
                      }
                      return true;
                   } );
-                  if( from_addr < max_nodes_per_host && (max_client_count == 0 || visitors < max_client_count)) {
+                  // peers on a unix domain socket are all on this host, p2p-max-nodes-per-host does not apply
+                  const bool local_peer = paddr.protocol().family() == AF_UNIX;
+                  if( (local_peer || from_addr < max_nodes_per_host) && (max_client_count == 0 || visitors < max_client_count)) {
                      fc_ilog( logger, "Accepted new connection: " + paddr_str );
                      new_connection->set_heartbeat_timeout( heartbeat_timeout );
                      if( new_connection->start_session()) {
@@ -2459,7 +3357,7 @@ namespace eosio {
                      }
 
                   } else {
-                     if( from_addr >= max_nodes_per_host ) {
+                     if( !local_peer && from_addr >= max_nodes_per_host ) {
                         fc_dlog( logger, "Number of connections (${n}) from ${ra} exceeds limit ${l}",
                                  ("n", from_addr + 1)( "ra", paddr_str )( "l", max_nodes_per_host ));
                      } else {
@@ -2467,7 +3365,7 @@ namespace eosio {
                      }
                      // new_connection never added to connections and start_session not called, lifetime will end
                      boost::system::error_code ec;
-                     socket->shutdown( tcp::socket::shutdown_both, ec );
+                     socket->shutdown( stream_socket::shutdown_both, ec );
                      socket->close( ec );
                   }
                }
@@ -2486,7 +3384,7 @@ namespace eosio {
                      return;
                }
             }
-            start_listen_loop();
+            start_listen_loop( acc );
          }));
       } );
    }
@@ -2541,6 +3439,7 @@ namespace eosio {
                      }
                      EOS_ASSERT(bytes_transferred <= conn->pending_message_buffer.bytes_to_write(), plugin_exception, "");
                      conn->pending_message_buffer.advance_write_ptr(bytes_transferred);
+                     conn->counters.bytes_received += bytes_transferred;
                      while (conn->pending_message_buffer.bytes_to_read() > 0) {
                         uint32_t bytes_in_buffer = conn->pending_message_buffer.bytes_to_read();
 
@@ -2577,6 +3476,7 @@ namespace eosio {
                            }
                         }
                      }
+                     conn->flush_trx_batch();
                      if( !close_connection ) conn->start_read_message();
                   } else {
                      if (ec.value() != boost::asio::error::eof) {
@@ -2620,8 +3520,92 @@ namespace eosio {
       }
    }
 
+   template<typename DataStream>
+   void skip_bytes( DataStream& ds, uint32_t len ) {
+      char buf[1024];
+      while( len > 0 ) {
+         const uint32_t n = std::min<uint32_t>( len, sizeof(buf) );
+         ds.read( buf, n );
+         len -= n;
+      }
+   }
+
+   template<typename DataStream>
+   void skip_signatures( DataStream& ds ) {
+      unsigned_int count{};
+      fc::raw::unpack( ds, count );
+      for( uint32_t i = 0; i < count.value; ++i ) {
+         signature_type sig;
+         fc::raw::unpack( ds, sig );
+      }
+   }
+
+   template<typename DataStream>
+   void skip_bytes_vector( DataStream& ds ) {
+      unsigned_int count{};
+      fc::raw::unpack( ds, count );
+      for( uint32_t i = 0; i < count.value; ++i ) {
+         unsigned_int len{};
+         fc::raw::unpack( ds, len );
+         skip_bytes( ds, len.value );
+      }
+   }
+
+   /**
+    * Reads the id of the packed_transaction_v0 or packed_transaction at the current position of ds without unpacking
+    * the transaction, its signatures or context free data. The id is the hash of the packed transaction, computed
+    * directly over the message buffer. Returns empty if the transaction is compressed, as it then needs to be
+    * decompressed to be identified. A malformed message yields an id no peer can match and fails when unpacked.
+    */
+   template<typename DataStream>
+   std::optional<transaction_id_type> peek_trx_id( DataStream& ds, bool v0 ) {
+      using prunable_data_type = packed_transaction::prunable_data_type;
+      fc::enum_type<uint8_t, packed_transaction::compression_type> compression;
+      if( v0 ) {
+         skip_signatures( ds );
+         fc::raw::unpack( ds, compression );
+         unsigned_int packed_cfd_len{};
+         fc::raw::unpack( ds, packed_cfd_len );
+         skip_bytes( ds, packed_cfd_len.value );
+      } else {
+         fc::raw::unpack( ds, compression );
+         unsigned_int prunable_which{};
+         fc::raw::unpack( ds, prunable_which );
+         if( prunable_which.value == fc::get_index<prunable_data_type::prunable_data_t, prunable_data_type::full_legacy>() ) {
+            skip_signatures( ds );
+            unsigned_int packed_cfd_len{};
+            fc::raw::unpack( ds, packed_cfd_len );
+            skip_bytes( ds, packed_cfd_len.value );
+         } else if( prunable_which.value == fc::get_index<prunable_data_type::prunable_data_t, prunable_data_type::full>() ) {
+            skip_signatures( ds );
+            skip_bytes_vector( ds );
+         } else { // pruned, uncommon over p2p
+            return {};
+         }
+      }
+      if( compression != packed_transaction::compression_type::none )
+         return {};
+
+      unsigned_int packed_trx_len{};
+      fc::raw::unpack( ds, packed_trx_len );
+      transaction_id_type::encoder enc;
+      char buf[1024];
+      uint32_t len = packed_trx_len.value;
+      while( len > 0 ) {
+         const uint32_t n = std::min<uint32_t>( len, sizeof(buf) );
+         ds.read( buf, n );
+         enc.write( buf, n );
+         len -= n;
+      }
+      return enc.result();
+   }
+
    // called from connection strand
    bool connection::process_next_message( uint32_t message_length ) {
+      const auto start = fc::time_point::now();
+      auto update_processing_time = fc::make_scoped_exit( [this, start]() {
+         counters.message_processing_us += (fc::time_point::now() - start).count();
+      } );
       try {
          latest_msg_time = get_time();
 
@@ -2629,6 +3613,7 @@ namespace eosio {
          auto peek_ds = pending_message_buffer.create_peek_datastream();
          unsigned_int which{};
          fc::raw::unpack( peek_ds, which );
+         counters.message_received( which );
          if( which == signed_block_which || which == signed_block_v0_which ) {
             return process_next_block_message( message_length );
 
@@ -2661,20 +3646,48 @@ namespace eosio {
       fc::raw::unpack( peek_ds, bh );
 
       const block_id_type blk_id = bh.calculate_id();
+      if( !accept_block_header( blk_id, bh ) ) {
+         pending_message_buffer.advance_read_ptr( message_length );
+         return true;
+      }
+
+      auto ds = pending_message_buffer.create_datastream();
+      fc::raw::unpack( ds, which );
+      shared_ptr<signed_block> ptr;
+      if( which == signed_block_which ) {
+         ptr = std::make_shared<signed_block>();
+         fc::raw::unpack( ds, *ptr );
+      } else {
+         signed_block_v0 sb_v0;
+         fc::raw::unpack( ds, sb_v0 );
+         ptr = std::make_shared<signed_block>( std::move( sb_v0 ), true );
+      }
+
+      return process_block( blk_id, std::move( ptr ) );
+   }
+
+   // called from connection strand
+   // returns false if the block should not be processed, either because it is already known or is too old
+   bool connection::accept_block_header( const block_id_type& blk_id, const block_header& bh ) {
       const uint32_t blk_num = bh.block_num();
       if( my_impl->dispatcher->have_block( blk_id ) ) {
          fc_dlog( logger, "canceling wait on ${p}, already received block ${num}, id ${id}...",
                   ("p", peer_name())("num", blk_num)("id", blk_id.str().substr(8,16)) );
          my_impl->sync_master->sync_recv_block( shared_from_this(), blk_id, blk_num, false );
          cancel_wait();
-
-         pending_message_buffer.advance_read_ptr( message_length );
-         return true;
+         ++counters.duplicate_blocks_received;
+         return false;
       }
+      ++counters.blocks_received;
+      if( my_impl->sync_master->syncing_with_peer() ) {
+         record_sync_block_arrival();
+      }
+      const fc::microseconds latency = fc::time_point::now() - bh.timestamp;
       fc_dlog( logger, "${p} received block ${num}, id ${id}..., latency: ${latency}",
                ("p", peer_name())("num", bh.block_num())("id", blk_id.str().substr(8,16))
-                     ("latency", (fc::time_point::now() - bh.timestamp).count()/1000) );
+                     ("latency", latency.count()/1000) );
       if( !my_impl->sync_master->syncing_with_peer() ) { // guard against peer thinking it needs to send us old blocks
+         counters.block_latency( latency );
          uint32_t lib = 0;
          std::tie( lib, std::ignore, std::ignore, std::ignore, std::ignore, std::ignore ) = my_impl->get_chain_info();
          if( blk_num < lib ) {
@@ -2690,24 +3703,14 @@ namespace eosio {
                send_handshake();
                cancel_wait();
             }
-
-            pending_message_buffer.advance_read_ptr( message_length );
-            return true;
+            return false;
          }
       }
+      return true;
+   }
 
-      auto ds = pending_message_buffer.create_datastream();
-      fc::raw::unpack( ds, which );
-      shared_ptr<signed_block> ptr;
-      if( which == signed_block_which ) {
-         ptr = std::make_shared<signed_block>();
-         fc::raw::unpack( ds, *ptr );
-      } else {
-         signed_block_v0 sb_v0;
-         fc::raw::unpack( ds, sb_v0 );
-         ptr = std::make_shared<signed_block>( std::move( sb_v0 ), true );
-      }
-
+   // called from connection strand
+   bool connection::process_block( const block_id_type& blk_id, signed_block_ptr ptr ) {
       auto is_webauthn_sig = []( const fc::crypto::signature& s ) {
          return s.which() == fc::get_index<fc::crypto::signature::storage_type, fc::crypto::webauthn::signature>();
       };
@@ -2738,6 +3741,7 @@ namespace eosio {
          return true;
       }
 
+      ++counters.trxs_received;
       const unsigned long trx_in_progress_sz = this->trx_in_progress_size.load();
 
       auto report_dropping_trx = [](const transaction_id_type& trx_id, unsigned long trx_in_progress_sz) {
@@ -2746,65 +3750,72 @@ namespace eosio {
          my_impl->producer_plug->log_failed_transaction(trx_id, reason);
       };
 
+      // identify the trx from the message buffer so duplicates are dropped without unpacking them
+      std::optional<transaction_id_type> trx_id;
+      {
+         auto peek_ds = pending_message_buffer.create_peek_datastream();
+         unsigned_int which{};
+         fc::raw::unpack( peek_ds, which );
+         if( which == trx_message_v1_which ) {
+            fc::raw::unpack( peek_ds, trx_id );
+         }
+         if( !trx_id ) {
+            trx_id = peek_trx_id( peek_ds, which == packed_transaction_v0_which );
+         }
+      }
+      if( trx_id ) {
+         if( trx_in_progress_sz > def_max_trx_in_progress_size ) {
+            report_dropping_trx( *trx_id, trx_in_progress_sz );
+            pending_message_buffer.advance_read_ptr( message_length );
+            return true;
+         }
+         if( my_impl->dispatcher->add_peer_txn( *trx_id, connection_id ) ) {
+            fc_dlog( logger, "got a duplicate transaction - dropping" );
+            ++counters.duplicate_trxs_received;
+            pending_message_buffer.advance_read_ptr( message_length );
+            return true;
+         }
+      }
+
       bool have_trx = false;
       shared_ptr<packed_transaction> ptr;
       auto ds = pending_message_buffer.create_datastream();
-      const auto buff_size_start = pending_message_buffer.bytes_to_read();
       unsigned_int which{};
       fc::raw::unpack( ds, which );
       if( which == trx_message_v1_which ) {
-         std::optional<transaction_id_type> trx_id;
-         fc::raw::unpack( ds, trx_id );
-         if( trx_id ) {
-            if (trx_in_progress_sz > def_max_trx_in_progress_size) {
-               report_dropping_trx(*trx_id, trx_in_progress_sz);
-               return true;
-            }
-            have_trx = my_impl->dispatcher->add_peer_txn( *trx_id, connection_id );
-         }
-
-         if( have_trx ) {
-            const auto buff_size_current = pending_message_buffer.bytes_to_read();
-            pending_message_buffer.advance_read_ptr( message_length - (buff_size_start - buff_size_current) );
-         } else {
-            std::shared_ptr<packed_transaction> trx;
-            fc::raw::unpack( ds, trx );
-            ptr = std::move( trx );
-
-            if (ptr && trx_id && *trx_id != ptr->id()) {
-               my_impl->producer_plug->log_failed_transaction(*trx_id, "Provided trx_id does not match provided packed_transaction");
-               EOS_ASSERT(false, transaction_id_type_exception,
-                        "Provided trx_id does not match provided packed_transaction" );
-            }
-            
-            if( !trx_id ) {
-               if (trx_in_progress_sz > def_max_trx_in_progress_size) {
-                  report_dropping_trx(ptr->id(), trx_in_progress_sz);
-                  return true;
-               }
-               have_trx = my_impl->dispatcher->have_txn( ptr->id() );
-            }
-            node_transaction_state nts = {ptr->id(), ptr->expiration(), 0, connection_id};
-            my_impl->dispatcher->add_peer_txn( nts );
+         trx_message_v1 msg;
+         fc::raw::unpack( ds, msg );
+         ptr = std::move( msg.trx );
+
+         if( ptr && msg.trx_id && *msg.trx_id != ptr->id() ) {
+            my_impl->producer_plug->log_failed_transaction(*msg.trx_id, "Provided trx_id does not match provided packed_transaction");
+            EOS_ASSERT(false, transaction_id_type_exception,
+                     "Provided trx_id does not match provided packed_transaction" );
          }
-
       } else {
          packed_transaction_v0 pt_v0;
          fc::raw::unpack( ds, pt_v0 );
-         if( trx_in_progress_sz > def_max_trx_in_progress_size) {
-            report_dropping_trx(pt_v0.id(), trx_in_progress_sz);
+         ptr = std::make_shared<packed_transaction>( std::move( pt_v0 ), true );
+      }
+
+      if( trx_id && *trx_id != ptr->id() ) {
+         // bytes after the packed transaction change the peeked hash but not the id, identify it by its id instead
+         fc_dlog( logger, "peeked trx id ${p} does not match trx id ${id}", ("p", *trx_id)("id", ptr->id()) );
+         trx_id.reset();
+      }
+      if( !trx_id ) { // compressed or peeked id mismatch, only identifiable once unpacked
+         if( trx_in_progress_sz > def_max_trx_in_progress_size ) {
+            report_dropping_trx( ptr->id(), trx_in_progress_sz );
             return true;
          }
-         have_trx = my_impl->dispatcher->have_txn( pt_v0.id() );
-         node_transaction_state nts = {pt_v0.id(), pt_v0.expiration(), 0, connection_id};
-         my_impl->dispatcher->add_peer_txn( nts );
-         if ( !have_trx ) {
-            ptr = std::make_shared<packed_transaction>( pt_v0, true );
-         }
+         have_trx = my_impl->dispatcher->have_txn( ptr->id() );
       }
+      node_transaction_state nts = {ptr->id(), ptr->expiration(), 0, connection_id};
+      my_impl->dispatcher->add_peer_txn( nts, have_trx ? packed_transaction_ptr() : ptr );
 
       if( have_trx ) {
          fc_dlog( logger, "got a duplicate transaction - dropping" );
+         ++counters.duplicate_trxs_received;
          return true;
       }
 
@@ -2967,6 +3978,7 @@ namespace eosio {
             enqueue( go_away_message( authentication ) );
             return;
          }
+         trusted_peer = my_impl->is_trusted_peer( msg );
 
          uint32_t peer_lib = msg.last_irreversible_block_num;
          connection_wptr weak = shared_from_this();
@@ -3003,6 +4015,10 @@ namespace eosio {
          if( sent_handshake_count == 0 ) {
             send_handshake();
          }
+
+         if( protocol_version >= proto_sync_compression ) {
+            enqueue( sync_compression_message{ my_impl->p2p_accept_compressed_sync_blocks } );
+         }
       }
 
       std::unique_lock<std::mutex> g_conn( conn_mtx );
@@ -3055,6 +4071,11 @@ namespace eosio {
       }
 
       double offset = (double(rec - org) + double(msg.xmt - dst)) / 2;
+      const tstamp delay_ns = (msg.dst - msg.org) - (msg.xmt - msg.rec);
+      if( delay_ns > 0 ) {
+         const int64_t prev = rtt_us;
+         rtt_us = prev == 0 ? delay_ns / 1000 : (prev * 7 + delay_ns / 1000) / 8;
+      }
       double NsecPerUsec{1000};
 
       if( logger.is_enabled( fc::log_level::all ) )
@@ -3196,31 +4217,251 @@ namespace eosio {
       return trx->get_estimated_size();
    }
 
+   // called from connection strand
    void connection::handle_message( packed_transaction_ptr trx ) {
       const auto& tid = trx->id();
       peer_dlog( this, "received packed_transaction ${id}", ("id", tid) );
 
       trx_in_progress_size += calc_trx_size( trx );
-      app().post( priority::low, [trx{std::move(trx)}, weak = weak_from_this()]() {
-         my_impl->chain_plug->accept_transaction( trx,
-            [weak, trx](const std::variant<fc::exception_ptr, transaction_trace_ptr>& result) mutable {
-         // next (this lambda) called from application thread
-         if (std::holds_alternative<fc::exception_ptr>(result)) {
-            fc_dlog( logger, "bad packed_transaction : ${m}", ("m", std::get<fc::exception_ptr>(result)->what()) );
+      pending_trx_batch.emplace_back( std::move( trx ) );
+      if( pending_trx_batch.size() >= my_impl->trx_recovery_batch_size ) {
+         flush_trx_batch();
+      }
+   }
+
+   // called from connection strand
+   void connection::flush_trx_batch() {
+      if( pending_trx_batch.empty() ) return;
+      vector<packed_transaction_ptr> batch;
+      batch.swap( pending_trx_batch );
+      // signature recovery is cpu bound, keep it off the net thread pool like controller::start_recover_keys does
+      boost::asio::post( *my_impl->chain_thread_pool,
+                         [batch{std::move(batch)}, trusted = trusted_peer, weak = weak_from_this()]() mutable {
+         my_impl->recover_trx_batch( std::move( batch ), trusted, weak );
+      } );
+   }
+
+   // thread safe
+   transaction_metadata_ptr net_plugin_impl::recover_trx_keys( const packed_transaction_ptr& trx, const fc::microseconds& time_limit ) const {
+      const vector<bytes>* context_free_data = trx->get_context_free_data();
+      if( !context_free_data ) { // pruned, let recover_keys report it
+         return transaction_metadata::recover_keys( trx, chain_id, time_limit, max_signature_length );
+      }
+      const digest_type digest = trx->get_transaction().sig_digest( chain_id, *context_free_data );
+      transaction_metadata_ptr trx_meta = recovered_keys->get( digest, trx );
+      if( !trx_meta ) {
+         trx_meta = transaction_metadata::recover_keys( trx, chain_id, time_limit, max_signature_length );
+         recovered_keys->add( digest, trx_meta );
+      }
+      return trx_meta;
+   }
+
+   // called from chain thread pool, recovers keys of the whole batch before posting each trx to the main thread
+   void net_plugin_impl::recover_trx_batch( vector<packed_transaction_ptr> batch, bool trusted, const connection_wptr& weak ) const {
+      const auto trx_priority = trusted ? priority::medium : priority::low;
+      // max-transaction-time can be changed at runtime via producer update_runtime_options
+      fc::microseconds time_limit = fc::microseconds::maximum();
+      if( producer_plug ) {
+         const int32_t max_trx_time_ms = producer_plug->get_max_transaction_time_ms();
+         if( max_trx_time_ms >= 0 ) time_limit = fc::milliseconds( max_trx_time_ms );
+      }
+      const trx_pre_validation_state_ptr pre_validation_state = producer_plug ? producer_plug->get_trx_pre_validation_state()
+                                                                              : trx_pre_validation_state_ptr{};
+      for( auto& trx : batch ) {
+         transaction_metadata_ptr trx_meta;
+         auto exception_handler = [&trx, &weak](fc::exception_ptr ex) {
+            fc_dlog( logger, "bad packed_transaction ${id} : ${m}", ("id", trx->id())("m", ex->what()) );
+            connection_ptr conn = weak.lock();
+            if( conn ) {
+               conn->trx_in_progress_size -= calc_trx_size( trx );
+            }
+         };
+         try {
+            // same stateless checks as producer_plugin applies to api transactions, only recover keys if they pass
+            if( pre_validation_state ) pre_validate_transaction( *trx, *pre_validation_state );
+            trx_meta = recover_trx_keys( trx, time_limit );
+         } CATCH_AND_CALL(exception_handler);
+         if( !trx_meta ) continue;
+
+         app().post( trx_priority, [trx_meta{std::move(trx_meta)}, weak]() {
+            my_impl->chain_plug->accept_transaction( trx_meta,
+               [weak, trx = trx_meta->packed_trx()](const std::variant<fc::exception_ptr, transaction_trace_ptr>& result) mutable {
+            // next (this lambda) called from application thread
+            if (std::holds_alternative<fc::exception_ptr>(result)) {
+               fc_dlog( logger, "bad packed_transaction : ${m}", ("m", std::get<fc::exception_ptr>(result)->what()) );
+            } else {
+               const transaction_trace_ptr& trace = std::get<transaction_trace_ptr>(result);
+               if( !trace->except ) {
+                  fc_dlog( logger, "chain accepted transaction, bcast ${id}", ("id", trace->id) );
+               } else {
+                  fc_elog( logger, "bad packed_transaction : ${m}", ("m", trace->except->what()));
+               }
+            }
+            connection_ptr conn = weak.lock();
+            if( conn ) {
+               conn->trx_in_progress_size -= calc_trx_size( trx );
+            }
+           });
+         });
+      }
+   }
+
+   // called from connection strand
+   void connection::handle_message( const compact_block_message& msg ) {
+      const block_id_type blk_id = msg.header.calculate_id();
+      peer_dlog( this, "received compact_block_message ${num}", ("num", msg.header.block_num()) );
+      if( !accept_block_header( blk_id, msg.header ) ) {
+         return;
+      }
+
+      auto ptr = std::make_shared<signed_block>( msg.header );
+      ptr->prune_state = msg.prune_state;
+      ptr->block_extensions = msg.block_extensions;
+      vector<uint32_t> missing;
+      for( uint32_t i = 0; i < msg.transactions.size(); ++i ) {
+         const auto& cr = msg.transactions[i];
+         transaction_receipt r;
+         static_cast<transaction_receipt_header&>(r) = cr;
+         if( std::holds_alternative<transaction_id_type>( cr.trx ) ) {
+            r.trx = std::get<transaction_id_type>( cr.trx );
          } else {
-            const transaction_trace_ptr& trace = std::get<transaction_trace_ptr>(result);
-            if( !trace->except ) {
-               fc_dlog( logger, "chain accepted transaction, bcast ${id}", ("id", trace->id) );
+            auto trx = my_impl->dispatcher->get_txn( std::get<short_trx_id_type>( cr.trx ) );
+            if( trx ) {
+               r.trx.emplace<packed_transaction>( *trx );
             } else {
-               fc_elog( logger, "bad packed_transaction : ${m}", ("m", trace->except->what()));
+               r.trx.emplace<packed_transaction>();
+               missing.push_back( i );
             }
          }
-         connection_ptr conn = weak.lock();
-         if( conn ) {
-            conn->trx_in_progress_size -= calc_trx_size( trx );
+         ptr->transactions.emplace_back( std::move( r ) );
+      }
+
+      if( missing.empty() ) {
+         process_compact_block( blk_id, std::move( ptr ) );
+         return;
+      }
+
+      auto same_id = [&blk_id]( const pending_compact_block& p ) { return p.id == blk_id; };
+      if( std::find_if( pending_compacts.begin(), pending_compacts.end(), same_id ) != pending_compacts.end() ) {
+         peer_dlog( this, "compact block ${num} already waiting on trxs", ("num", msg.header.block_num()) );
+         return;
+      }
+      if( pending_compacts.size() >= max_pending_compact_blocks ) {
+         // its trxs may still arrive, they are then ignored and the full block is used instead
+         peer_dlog( this, "too many pending compact blocks, requesting full block ${num}",
+                    ("num", pending_compacts.front().block->block_num()) );
+         request_full_block( pending_compacts.front().id );
+         pending_compacts.pop_front();
+      }
+      peer_dlog( this, "requesting ${m} of ${t} trxs of compact block ${num}",
+                 ("m", missing.size())("t", msg.transactions.size())("num", msg.header.block_num()) );
+      enqueue( request_compact_trxs_message{ blk_id, missing } );
+      pending_compacts.emplace_back( pending_compact_block{ blk_id, std::move( ptr ), std::move( missing ) } );
+   }
+
+   // called from connection strand
+   void connection::add_sent_compact( const block_id_type& id, const signed_block_ptr& sb ) {
+      if( sent_compacts.size() >= max_pending_compact_blocks ) sent_compacts.pop_front();
+      sent_compacts.emplace_back( id, sb );
+   }
+
+   // called from connection strand
+   void connection::handle_message( const request_compact_trxs_message& msg ) {
+      peer_dlog( this, "received request_compact_trxs_message for ${m} trxs", ("m", msg.indexes.size()) );
+      // only blocks recently sent to this peer as compact blocks are served, the peer requests the full block otherwise
+      auto itr = std::find_if( sent_compacts.begin(), sent_compacts.end(),
+                               [&msg]( const auto& s ) { return s.first == msg.id; } );
+      if( itr == sent_compacts.end() ) {
+         peer_dlog( this, "request_compact_trxs_message for unknown block ${id}", ("id", msg.id) );
+         return;
+      }
+      const signed_block_ptr b = itr->second;
+      sent_compacts.erase( itr );
+      compact_trxs_message reply{ msg.id, {} };
+      reply.trxs.reserve( msg.indexes.size() );
+      for( auto i : msg.indexes ) {
+         if( i >= b->transactions.size() || !std::holds_alternative<packed_transaction>( b->transactions[i].trx ) ) {
+            fc_elog( logger, "Invalid request_compact_trxs_message, index ${i} for block ${n}, closing ${p}",
+                     ("i", i)("n", b->block_num())("p", peer_name()) );
+            close();
+            return;
          }
-        });
-      });
+         reply.trxs.emplace_back( std::get<packed_transaction>( b->transactions[i].trx ) );
+      }
+      enqueue( reply );
+   }
+
+   // called from connection strand
+   void connection::handle_message( const compact_trxs_message& msg ) {
+      peer_dlog( this, "received compact_trxs_message with ${t} trxs", ("t", msg.trxs.size()) );
+      auto itr = std::find_if( pending_compacts.begin(), pending_compacts.end(),
+                               [&msg]( const pending_compact_block& p ) { return p.id == msg.id; } );
+      if( itr == pending_compacts.end() ) {
+         fc_dlog( logger, "no pending compact block for ${id}, ignoring compact_trxs_message from ${p}", ("id", msg.id)("p", peer_name()) );
+         return;
+      }
+      auto pending = std::move( *itr );
+      pending_compacts.erase( itr );
+      if( pending.missing.size() != msg.trxs.size() ) {
+         fc_elog( logger, "Invalid compact_trxs_message, expected ${e} trxs got ${t}, closing ${p}",
+                  ("e", pending.missing.size())("t", msg.trxs.size())("p", peer_name()) );
+         close();
+         return;
+      }
+      for( size_t i = 0; i < msg.trxs.size(); ++i ) {
+         pending.block->transactions[pending.missing[i]].trx.emplace<packed_transaction>( msg.trxs[i] );
+      }
+      process_compact_block( pending.id, std::move( pending.block ) );
+   }
+
+   // called from connection strand
+   void connection::handle_message( const sync_compression_message& msg ) {
+      peer_dlog( this, "received sync_compression_message, accept compressed blocks ${a}", ("a", msg.accept_compressed_blocks) );
+      peer_accepts_compressed_blocks = msg.accept_compressed_blocks;
+   }
+
+   // called from connection strand
+   void connection::handle_message( const compressed_block_message& msg ) {
+      if( !my_impl->p2p_accept_compressed_sync_blocks ) {
+         fc_elog( logger, "compressed_block_message not accepted, closing ${p}", ("p", peer_name()) );
+         close();
+         return;
+      }
+      const block_id_type blk_id = msg.header.calculate_id();
+      if( !accept_block_header( blk_id, msg.header ) ) {
+         return;
+      }
+      signed_block_ptr ptr = decompress_block( msg );
+      if( ptr->calculate_id() != blk_id ) {
+         fc_elog( logger, "compressed_block_message header does not match block ${num}, closing ${p}",
+                  ("num", msg.header.block_num())("p", peer_name()) );
+         close();
+         return;
+      }
+      process_block( blk_id, std::move( ptr ) );
+   }
+
+   // called from connection strand
+   void connection::process_compact_block( const block_id_type& blk_id, signed_block_ptr ptr ) {
+      // a short id collision or a transaction packed differently than the one included in the block results in a
+      // transaction_mroot mismatch, fall back to requesting the full block
+      deque<digest_type> trx_digests;
+      for( const auto& r : ptr->transactions )
+         trx_digests.emplace_back( r.digest() );
+      if( merkle( std::move( trx_digests ) ) != ptr->transaction_mroot ) {
+         peer_dlog( this, "compact block ${num} reconstruction failed, requesting full block", ("num", ptr->block_num()) );
+         request_full_block( blk_id );
+         return;
+      }
+      process_block( blk_id, std::move( ptr ) );
+   }
+
+   // called from connection strand
+   void connection::request_full_block( const block_id_type& blk_id ) {
+      request_message req;
+      req.req_blocks.mode = normal;
+      req.req_blocks.ids.push_back( blk_id );
+      enqueue( req );
    }
 
    // called from connection strand
@@ -3234,20 +4475,24 @@ namespace eosio {
             return;
          }
       }
+      if( my_impl->sync_master->sync_reorder_block( shared_from_this(), id, ptr ) ) {
+         return;
+      }
       app().post(priority::medium, [ptr{std::move(ptr)}, id, c = shared_from_this()]() mutable {
          c->process_signed_block( id, std::move( ptr ) );
       });
    }
 
    // called from application thread
-   void connection::process_signed_block( const block_id_type& blk_id, signed_block_ptr msg ) {
+   void connection::process_signed_block( const block_id_type& blk_id, signed_block_ptr msg, bool reordered ) {
       controller& cc = my_impl->chain_plug->chain();
       uint32_t blk_num = msg->block_num();
       // use c in this method instead of this to highlight that all methods called on c-> must be thread safe
       connection_ptr c = shared_from_this();
 
-      // if we have closed connection then stop processing
-      if( !c->socket_is_open() )
+      // if we have closed connection then stop processing, unless the sync reorder buffer already dispatched the block,
+      // then blocks from other peers after it can only be linked once it is applied
+      if( !c->socket_is_open() && !reordered )
          return;
 
       try {
@@ -3299,6 +4544,10 @@ namespace eosio {
             sync_master->sync_recv_block( c, blk_id, blk_num, true );
          });
       } else {
+         if( reordered ) {
+            // before any block dispatched after this one runs on the main thread
+            my_impl->sync_master->rejected_reordered_block( blk_num );
+         }
          c->strand.post( [sync_master = my_impl->sync_master.get(), dispatcher = my_impl->dispatcher.get(), c, blk_id, blk_num]() {
             sync_master->rejected_block( c, blk_num );
             dispatcher->rejected_block( blk_id );
@@ -3479,6 +4728,7 @@ namespace eosio {
    void net_plugin_impl::on_irreversible_block( const block_state_ptr& block) {
       fc_dlog( logger, "on_irreversible_block, blk num = ${num}, id = ${id}", ("num", block->block_num)("id", block->id) );
       update_chain_info();
+      block_buffers->on_irreversible_block( block->id );
    }
 
    // called from application thread
@@ -3553,6 +4803,17 @@ namespace eosio {
       return true;
    }
 
+   bool net_plugin_impl::is_trusted_peer(const handshake_message& msg) const {
+      // msg.key is only verified against the handshake signature when connections are restricted
+      if( !(allowed_connections & (Producers | Specified)) || msg.sig == chain::signature_type() )
+         return false;
+      if( std::find( allowed_peers.begin(), allowed_peers.end(), msg.key ) != allowed_peers.end() )
+         return true;
+      if( private_keys.find( msg.key ) != private_keys.end() )
+         return true;
+      return producer_plug != nullptr && producer_plug->is_producer_key( msg.key );
+   }
+
    chain::public_key_type net_plugin_impl::get_authentication_key() const {
       if(!private_keys.empty())
          return private_keys.begin()->first;
@@ -3628,17 +4889,24 @@ namespace eosio {
       cfg.add_options()
          ( "p2p-listen-endpoint", bpo::value<string>()->default_value( "0.0.0.0:9876" ), "The actual host:port used to listen for incoming p2p connections.")
          ( "p2p-server-address", bpo::value<string>(), "An externally accessible host:port for identifying this node. Defaults to p2p-listen-endpoint.")
+         ( "p2p-listen-unix-socket", bpo::value<string>(),
+           "Path of a unix domain socket to listen on for incoming p2p connections from peers on the same host, in addition to p2p-listen-endpoint.")
          ( "p2p-peer-address", bpo::value< vector<string> >()->composing(),
            "The public endpoint of a peer node to connect to. Use multiple p2p-peer-address options as needed to compose a network.\n"
-           "  Syntax: host:port[:<trx>|<blk>]\n"
+           "  Syntax: host:port[:<trx>|<blk>] or unix:path[:<trx>|<blk>] for a peer on the same host listening on p2p-listen-unix-socket\n"
            "  The optional 'trx' and 'blk' indicates to node that only transactions 'trx' or blocks 'blk' should be sent."
            "  Examples:\n"
            "    p2p.eos.io:9876\n"
            "    p2p.trx.eos.io:9876:trx\n"
-           "    p2p.blk.eos.io:9876:blk\n")
+           "    p2p.blk.eos.io:9876:blk\n"
+           "    unix:/var/run/nodeos/p2p.sock\n")
          ( "p2p-max-nodes-per-host", bpo::value<int>()->default_value(def_max_nodes_per_host), "Maximum number of client nodes from any single IP address")
          ( "p2p-accept-transactions", bpo::value<bool>()->default_value(true), "Allow transactions received over p2p network to be evaluated and relayed if valid.")
          ( "p2p-reject-incomplete-blocks", bpo::value<bool>()->default_value(true), "Reject pruned signed_blocks even in light validation")
+         ( "p2p-accept-compressed-sync-blocks", bpo::value<bool>()->default_value(true),
+           "Ask peers to send compressed blocks when syncing from them. Trades cpu for bandwidth, disable when peers are on a fast local network.")
+         ( "p2p-sync-compression-min-size", bpo::value<uint32_t>()->default_value(def_sync_compression_min_size),
+           "Minimum packed size in bytes of a block sent during sync to a peer that accepts compressed blocks before it is compressed.")
          ( "agent-name", bpo::value<string>()->default_value("EOS Test Agent"), "The name supplied to identify this node amongst the peers.")
          ( "allowed-connection", bpo::value<vector<string>>()->multitoken()->default_value({"any"}, "any"), "Can be 'any' or 'producers' or 'specified' or 'none'. If 'specified', peer-key must be specified at least once. If only 'producers', peer-key is not required. 'producers' and 'specified' may be combined.")
          ( "peer-key", bpo::value<vector<string>>()->composing()->multitoken(), "Optional public key of peer allowed to connect.  May be used multiple times.")
@@ -3650,6 +4918,14 @@ namespace eosio {
          ( "net-threads", bpo::value<uint16_t>()->default_value(my->thread_pool_size),
            "Number of worker threads in net_plugin thread pool" )
          ( "sync-fetch-span", bpo::value<uint32_t>()->default_value(def_sync_fetch_span), "number of blocks to retrieve in a chunk from any individual peer during synchronization")
+         ( "p2p-block-buffer-cache-size-mb", bpo::value<uint32_t>()->default_value(def_block_buffer_cache_size_mb),
+           "Maximum size in MiB of the cache of serialized blocks shared by all peers, avoids reading and packing a block for each peer it is sent to. 0 disables the cache.")
+         ( "p2p-trx-recovery-batch-size", bpo::value<uint32_t>()->default_value(def_trx_recovery_batch_size),
+           "Maximum number of transactions received from a peer whose signing keys are recovered together on the net thread pool.")
+         ( "p2p-recovered-keys-cache-size", bpo::value<uint32_t>()->default_value(def_recovered_keys_cache_size),
+           "Number of transactions whose recovered signing keys are cached for reuse when the transaction is received again. 0 disables the cache.")
+         ( "sync-fetch-peers", bpo::value<uint32_t>()->default_value(def_sync_fetch_peers),
+           "maximum number of peers to retrieve chunks from concurrently during synchronization. Blocks received ahead of the next block to apply are held, up to sync-fetch-span * sync-fetch-peers blocks.")
          ( "use-socket-read-watermark", bpo::value<bool>()->default_value(false), "Enable experimental socket read watermark optimization")
          ( "peer-log-format", bpo::value<string>()->default_value( "[\"${_name}\" ${_ip}:${_port}]" ),
            "The string used to format peers when logging messages about them.  Variables are escaped with ${<variable name>}.\n"
@@ -3676,7 +4952,13 @@ namespace eosio {
       try {
          peer_log_format = options.at( "peer-log-format" ).as<string>();
 
-         my->sync_master.reset( new sync_manager( options.at( "sync-fetch-span" ).as<uint32_t>()));
+         const uint32_t sync_fetch_peers = options.at( "sync-fetch-peers" ).as<uint32_t>();
+         EOS_ASSERT( sync_fetch_peers > 0, chain::plugin_config_exception, "sync-fetch-peers must be greater than 0" );
+         my->sync_master.reset( new sync_manager( options.at( "sync-fetch-span" ).as<uint32_t>(), sync_fetch_peers ));
+         my->block_buffers.reset( new block_buffer_cache( size_t(options.at( "p2p-block-buffer-cache-size-mb" ).as<uint32_t>()) * 1024*1024 ));
+         my->trx_recovery_batch_size = options.at( "p2p-trx-recovery-batch-size" ).as<uint32_t>();
+         EOS_ASSERT( my->trx_recovery_batch_size > 0, chain::plugin_config_exception, "p2p-trx-recovery-batch-size must be greater than 0" );
+         my->recovered_keys.reset( new recovered_keys_cache( options.at( "p2p-recovered-keys-cache-size" ).as<uint32_t>() ));
 
          my->connector_period = std::chrono::seconds( options.at( "connection-cleanup-period" ).as<int>());
          my->max_cleanup_time_ms = options.at("max-cleanup-time-msec").as<int>();
@@ -3686,6 +4968,8 @@ namespace eosio {
          my->max_nodes_per_host = options.at( "p2p-max-nodes-per-host" ).as<int>();
          my->p2p_accept_transactions = options.at( "p2p-accept-transactions" ).as<bool>();
          my->p2p_reject_incomplete_blocks = options.at("p2p-reject-incomplete-blocks").as<bool>();
+         my->p2p_accept_compressed_sync_blocks = options.at("p2p-accept-compressed-sync-blocks").as<bool>();
+         my->p2p_sync_compression_min_size = options.at("p2p-sync-compression-min-size").as<uint32_t>();
 
          my->use_socket_read_watermark = options.at( "use-socket-read-watermark" ).as<bool>();
          my->keepalive_interval = std::chrono::milliseconds( options.at( "p2p-keepalive-interval-ms" ).as<int>() );
@@ -3701,6 +4985,11 @@ namespace eosio {
             EOS_ASSERT( my->p2p_address.length() <= max_p2p_address_length, chain::plugin_config_exception,
                         "p2p-listen-endpoint to long, must be less than ${m}", ("m", max_p2p_address_length) );
          }
+         if( options.count( "p2p-listen-unix-socket" ) ) {
+            my->p2p_listen_unix_socket = options.at( "p2p-listen-unix-socket" ).as<string>();
+            EOS_ASSERT( valid_local_socket_path( my->p2p_listen_unix_socket ), chain::plugin_config_exception,
+                        "p2p-listen-unix-socket must be non-empty and shorter than ${m} characters", ("m", sizeof( sockaddr_un::sun_path )) );
+         }
          if( options.count( "p2p-server-address" ) ) {
             my->p2p_server_address = options.at( "p2p-server-address" ).as<string>();
             EOS_ASSERT( my->p2p_server_address.length() <= max_p2p_address_length, chain::plugin_config_exception,
@@ -3713,6 +5002,12 @@ namespace eosio {
 
          if( options.count( "p2p-peer-address" )) {
             my->supplied_peers = options.at( "p2p-peer-address" ).as<vector<string> >();
+            for( const auto& peer : my->supplied_peers ) {
+               EOS_ASSERT( !is_local_peer_address( peer ) || valid_local_socket_path( local_socket_path( peer ) ),
+                           chain::plugin_config_exception,
+                           "p2p-peer-address ${p} socket path must be non-empty and shorter than ${m} characters",
+                           ("p", peer)("m", sizeof( sockaddr_un::sun_path )) );
+            }
          }
          if( options.count( "agent-name" )) {
             my->user_agent_name = options.at( "agent-name" ).as<string>();
@@ -3760,6 +5055,7 @@ namespace eosio {
          my->chain_id = my->chain_plug->get_chain_id();
          fc::rand_pseudo_bytes( my->node_id.data(), my->node_id.data_size());
          const controller& cc = my->chain_plug->chain();
+         my->max_signature_length = cc.configured_subjective_signature_length_limit();
 
          if( cc.get_read_mode() == db_read_mode::IRREVERSIBLE || cc.get_read_mode() == db_read_mode::READ_ONLY ) {
             if( my->p2p_accept_transactions ) {
@@ -3782,6 +5078,7 @@ namespace eosio {
       fc_ilog( logger, "my node_id is ${id}", ("id", my->node_id ));
 
       my->producer_plug = app().find_plugin<producer_plugin>();
+      my->chain_thread_pool = &my->chain_plug->chain().get_thread_pool();
 
       my->thread_pool.emplace( "net", my->thread_pool_size );
 
@@ -3834,7 +5131,23 @@ namespace eosio {
            throw e;
          }
          fc_ilog( logger, "starting listener, max clients is ${mc}",("mc",my->max_client_count) );
-         my->start_listen_loop();
+         my->start_listen_loop( *my->acceptor );
+      }
+      if( !my->p2p_listen_unix_socket.empty() ) {
+         try {
+            boost::system::error_code ec;
+            boost::filesystem::remove( my->p2p_listen_unix_socket, ec ); // stale socket from a previous run
+            local::stream_protocol::endpoint local_endpoint( my->p2p_listen_unix_socket );
+            my->local_acceptor.reset( new local::stream_protocol::acceptor( my_impl->thread_pool->get_executor() ) );
+            my->local_acceptor->open( local_endpoint.protocol() );
+            my->local_acceptor->bind( local_endpoint );
+            my->local_acceptor->listen();
+         } catch (const std::exception& e) {
+            elog( "net_plugin::plugin_startup failed to listen on ${path}", ("path", my->p2p_listen_unix_socket) );
+            throw;
+         }
+         fc_ilog( logger, "starting listener on unix socket ${path}", ("path", my->p2p_listen_unix_socket) );
+         my->start_listen_loop( *my->local_acceptor );
       }
       {
          chain::controller& cc = my->chain_plug->chain();
@@ -3914,6 +5227,12 @@ namespace eosio {
             my->acceptor->cancel( ec );
             my->acceptor->close( ec );
          }
+         if( my->local_acceptor ) {
+            boost::system::error_code ec;
+            my->local_acceptor->cancel( ec );
+            my->local_acceptor->close( ec );
+            boost::filesystem::remove( my->p2p_listen_unix_socket, ec );
+         }
 
          app().post( 0, [me = my](){} ); // keep my pointer alive until queue is drained
          fc_ilog( logger, "exit shutdown" );
@@ -3928,6 +5247,8 @@ namespace eosio {
       std::lock_guard<std::shared_mutex> g( my->connections_mtx );
       if( my->find_connection( host ) )
          return "already connected";
+      if( is_local_peer_address( host ) && !valid_local_socket_path( local_socket_path( host ) ) )
+         return "invalid unix socket path";
 
       connection_ptr c = std::make_shared<connection>( host );
       fc_dlog( logger, "calling active connector: ${h}", ("h", host) );
@@ -3970,6 +5291,16 @@ namespace eosio {
       return result;
    }
 
+   vector<connection_metrics> net_plugin::metrics()const {
+      vector<connection_metrics> result;
+      std::shared_lock<std::shared_mutex> g( my->connections_mtx );
+      result.reserve( my->connections.size() );
+      for( const auto& c : my->connections ) {
+         result.push_back( c->get_metrics() );
+      }
+      return result;
+   }
+
    // call with connections_mtx
    connection_ptr net_plugin_impl::find_connection( const string& host )const {
       for( const auto& c : connections )
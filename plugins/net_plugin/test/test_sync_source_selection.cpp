@@ -0,0 +1,84 @@
+#define BOOST_TEST_MODULE sync_source_selection
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/net_plugin/sync_source_selection.hpp>
+
+#include <vector>
+
+namespace {
+
+using namespace eosio;
+
+struct peer {
+   int64_t  block_interval_us = 0;
+   int64_t  rtt_us = 0;
+   uint32_t failures = 0;
+   bool     available = true;
+};
+
+constexpr uint32_t span = 100;
+
+size_t select( const std::vector<peer>& peers, size_t start ) {
+   auto best = select_sync_source( peers.begin(), peers.end(), peers.begin() + start, []( const peer& p ) -> std::optional<int64_t> {
+      if( !p.available ) return {};
+      return sync_score( p.block_interval_us, p.rtt_us, p.failures, span );
+   } );
+   return best - peers.begin();
+}
+
+BOOST_AUTO_TEST_SUITE( sync_source_selection_test )
+
+BOOST_AUTO_TEST_CASE( sync_score_test ) {
+   // unmeasured peers are tried first
+   BOOST_CHECK_EQUAL( sync_score( 0, 0, 0, span ), 0 );
+   BOOST_CHECK_EQUAL( sync_score( 0, 5000, 0, span ), 0 );
+
+   BOOST_CHECK_EQUAL( sync_score( 1000, 500, 0, span ), 1000 * span + 500 );
+   // each failure doubles the expected time
+   BOOST_CHECK_EQUAL( sync_score( 1000, 500, 1, span ), (1000 * span + 500) * 2 );
+   BOOST_CHECK_EQUAL( sync_score( 1000, 500, 3, span ), (1000 * span + 500) * 8 );
+   BOOST_CHECK_EQUAL( sync_score( 1000, 500, 100, span ), sync_score( 1000, 500, 16, span ) );
+
+   // unmeasured peers that failed rank below slow measured peers, more failures rank lower
+   const int64_t slow_measured = sync_score( 2'000'000, 1'000'000, 16, span );
+   BOOST_CHECK_GT( sync_score( 0, 0, 1, span ), slow_measured );
+   BOOST_CHECK_GT( sync_score( 0, 0, 2, span ), sync_score( 0, 0, 1, span ) );
+   BOOST_CHECK_EQUAL( sync_score( 0, 0, 100, span ), sync_score( 0, 0, 16, span ) );
+}
+
+BOOST_AUTO_TEST_CASE( selection_order_test ) {
+   std::vector<peer> peers = {
+      { 0,    0,   1 },   // 0: timed out before delivering a block
+      { 2000, 100, 0 },   // 1: measured, slow
+      { 1000, 100, 0 },   // 2: measured, fast
+      { 1000, 100, 0 },   // 3: measured, fast
+   };
+
+   // lowest score wins, ties go to the first candidate at or after start
+   BOOST_CHECK_EQUAL( select( peers, 0 ), 2u );
+   BOOST_CHECK_EQUAL( select( peers, 3 ), 3u );
+
+   // the failed unmeasured peer is only selected if it is the only candidate
+   peers[1].available = peers[2].available = peers[3].available = false;
+   BOOST_CHECK_EQUAL( select( peers, 1 ), 0u );
+
+   // a new unmeasured peer without failures is tried first
+   peers[1].available = peers[2].available = peers[3].available = true;
+   peers.push_back( peer{} );
+   BOOST_CHECK_EQUAL( select( peers, 0 ), 4u );
+
+   // a measured peer with failures ranks behind one without
+   peers[4].available = false;
+   peers[2].failures = 2;
+   BOOST_CHECK_EQUAL( select( peers, 0 ), 3u );
+
+   // none available
+   for( auto& p : peers ) p.available = false;
+   BOOST_CHECK_EQUAL( select( peers, 0 ), peers.size() );
+   std::vector<peer> none;
+   BOOST_CHECK_EQUAL( select( none, 0 ), 0u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -122,6 +122,10 @@ void producer_api_plugin::plugin_startup() {
                                  producer_plugin::get_supported_protocol_features_params), 201),
        CALL_WITH_400(producer, producer, get_account_ram_corrections,
             INVOKE_R_R(producer, get_account_ram_corrections, producer_plugin::get_account_ram_corrections_params), 201),
+       CALL_WITH_400(producer, producer, get_incoming_transaction_lanes,
+            INVOKE_R_R(producer, get_incoming_transaction_lanes, producer_plugin::get_incoming_transaction_lanes_params), 201),
+       CALL_WITH_400(producer, producer, get_transaction_timing,
+            INVOKE_R_R(producer, get_transaction_timing, producer_plugin::get_transaction_timing_params), 201),
    }, appbase::priority::medium_high);
 }
 
@@ -2,6 +2,9 @@
 
 #include <eosio/chain_plugin/chain_plugin.hpp>
 #include <eosio/signature_provider_plugin/signature_provider_plugin.hpp>
+#include <eosio/chain/unapplied_transaction_queue.hpp>
+#include <eosio/producer_plugin/transaction_timing.hpp>
+#include <eosio/producer_plugin/trx_pre_validation.hpp>
 
 #include <appbase/application.hpp>
 
@@ -71,6 +74,21 @@ public:
       std::optional<account_name>  more;
    };
 
+   struct get_incoming_transaction_lanes_params {
+      uint32_t limit = 100;
+   };
+
+   struct incoming_transaction_lanes {
+      chain::trx_lane_type                            lane_type = chain::trx_lane_type::none;
+      uint32_t                                        incoming_count = 0;
+      std::vector<chain::unapplied_transaction_lane>  lanes; // largest first
+   };
+
+   struct get_transaction_timing_params {
+      uint32_t limit = 100; // maximum number of actions to return, highest total time first
+      bool     reset = false;
+   };
+
    template<typename T>
    using next_function = std::function<void(const std::variant<fc::exception_ptr, T>&)>;
 
@@ -95,6 +113,10 @@ public:
    bool paused() const;
    void update_runtime_options(const runtime_options& options);
    runtime_options get_runtime_options() const;
+   /// thread safe, current max-transaction-time, negative if unlimited
+   int32_t get_max_transaction_time_ms() const;
+   /// thread safe, state for pre_validate_transaction of transactions passed in already recovered, empty if disabled
+   trx_pre_validation_state_ptr get_trx_pre_validation_state() const;
 
    void add_greylist_accounts(const greylist_params& params);
    void remove_greylist_accounts(const greylist_params& params);
@@ -113,6 +135,10 @@ public:
 
    get_account_ram_corrections_result  get_account_ram_corrections( const get_account_ram_corrections_params& params ) const;
 
+   incoming_transaction_lanes get_incoming_transaction_lanes( const get_incoming_transaction_lanes_params& params ) const;
+
+   transaction_timing::results get_transaction_timing( const get_transaction_timing_params& params );
+
    void log_failed_transaction(const transaction_id_type& trx_id, const char* reason) const;
 
  private:
@@ -130,3 +156,6 @@ FC_REFLECT(eosio::producer_plugin::scheduled_protocol_feature_activations, (prot
 FC_REFLECT(eosio::producer_plugin::get_supported_protocol_features_params, (exclude_disabled)(exclude_unactivatable))
 FC_REFLECT(eosio::producer_plugin::get_account_ram_corrections_params, (lower_bound)(upper_bound)(limit)(reverse))
 FC_REFLECT(eosio::producer_plugin::get_account_ram_corrections_result, (rows)(more))
+FC_REFLECT(eosio::producer_plugin::get_incoming_transaction_lanes_params, (limit))
+FC_REFLECT(eosio::producer_plugin::incoming_transaction_lanes, (lane_type)(incoming_count)(lanes))
+FC_REFLECT(eosio::producer_plugin::get_transaction_timing_params, (limit)(reset))
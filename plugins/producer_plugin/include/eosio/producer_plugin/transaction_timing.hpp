@@ -0,0 +1,125 @@
+#pragma once
+
+#include <eosio/chain/types.hpp>
+#include <eosio/chain/trace.hpp>
+
+#include <fc/reflect/reflect.hpp>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace eosio {
+
+using chain::account_name;
+using chain::action_name;
+using chain::transaction_trace;
+
+/**
+ * Histogram of durations in power of two microsecond buckets. Bucket 0 counts durations below 1us,
+ * bucket i counts durations in [2^(i-1), 2^i) us, the last bucket counts everything above.
+ */
+struct timing_histogram {
+   static constexpr size_t num_buckets = 24;
+
+   uint64_t                          count = 0;
+   uint64_t                          total_us = 0;
+   uint64_t                          max_us = 0;
+   std::vector<uint64_t>             buckets = std::vector<uint64_t>( num_buckets );
+
+   void add( const fc::microseconds& t ) {
+      const uint64_t us = t.count() > 0 ? t.count() : 0;
+      size_t bucket = 0;
+      for( uint64_t v = us; v > 0 && bucket < num_buckets - 1; v >>= 1 ) ++bucket;
+      ++buckets[bucket];
+      ++count;
+      total_us += us;
+      if( us > max_us ) max_us = us;
+   }
+};
+
+struct action_timing {
+   account_name     receiver;
+   account_name     account;
+   action_name      action;
+   timing_histogram elapsed;
+};
+
+/**
+ * Aggregates the phase times and action times of applied transactions, see transaction_trace::phase_times.
+ * Time spent in database intrinsics is not measured separately, it is part of exec and of the action times.
+ * Only used from the main thread.
+ */
+class transaction_timing {
+public:
+   /// distinct receiver/action pairs tracked individually, further pairs are only counted in action_histogram
+   static constexpr size_t max_tracked_actions = 10000;
+
+   struct results {
+      fc::time_point               since;
+      timing_histogram             init;
+      timing_histogram             auth;
+      timing_histogram             exec;
+      timing_histogram             finalize;
+      timing_histogram             wasm_instantiation;
+      timing_histogram             total;
+      timing_histogram             action;
+      std::vector<action_timing>   actions; // highest total time first
+   };
+
+   void add( const transaction_trace& trace ) {
+      if( _since == fc::time_point() ) _since = fc::time_point::now();
+      _init.add( trace.phase_times.init );
+      _auth.add( trace.phase_times.auth );
+      _exec.add( trace.phase_times.exec );
+      _finalize.add( trace.phase_times.finalize );
+      _wasm_instantiation.add( trace.phase_times.wasm_instantiation );
+      _total.add( trace.elapsed );
+      for( const auto& at : trace.action_traces ) {
+         _action.add( at.elapsed );
+         auto key = std::make_tuple( at.receiver, at.act.account, at.act.name );
+         auto itr = _actions.find( key );
+         if( itr == _actions.end() ) {
+            if( _actions.size() >= max_tracked_actions ) continue;
+            itr = _actions.emplace( key, timing_histogram{} ).first;
+         }
+         itr->second.add( at.elapsed );
+      }
+   }
+
+   results get( uint32_t limit ) const {
+      results r{ _since, _init, _auth, _exec, _finalize, _wasm_instantiation, _total, _action, {} };
+      r.actions.reserve( _actions.size() );
+      for( const auto& a : _actions ) {
+         r.actions.push_back( action_timing{ std::get<0>( a.first ), std::get<1>( a.first ), std::get<2>( a.first ), a.second } );
+      }
+      auto end = r.actions.size() > limit ? r.actions.begin() + limit : r.actions.end();
+      std::partial_sort( r.actions.begin(), end, r.actions.end(), []( const auto& lhs, const auto& rhs ) {
+         return lhs.elapsed.total_us > rhs.elapsed.total_us;
+      } );
+      r.actions.erase( end, r.actions.end() );
+      return r;
+   }
+
+   void clear() {
+      *this = transaction_timing{};
+   }
+
+private:
+   fc::time_point   _since;
+   timing_histogram _init;
+   timing_histogram _auth;
+   timing_histogram _exec;
+   timing_histogram _finalize;
+   timing_histogram _wasm_instantiation;
+   timing_histogram _total;
+   timing_histogram _action;
+   std::map<std::tuple<account_name, account_name, action_name>, timing_histogram> _actions;
+};
+
+} //eosio
+
+FC_REFLECT(eosio::timing_histogram, (count)(total_us)(max_us)(buckets))
+FC_REFLECT(eosio::action_timing, (receiver)(account)(action)(elapsed))
+FC_REFLECT(eosio::transaction_timing::results, (since)(init)(auth)(exec)(finalize)(wasm_instantiation)(total)(action)(actions))
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <eosio/chain/types.hpp>
+#include <eosio/chain/exceptions.hpp>
+#include <eosio/chain/transaction.hpp>
+#include <eosio/chain/chain_config.hpp>
+#include <eosio/chain/config.hpp>
+
+#include <memory>
+
+namespace eosio {
+
+using chain::packed_transaction;
+using chain::transaction;
+
+/// chain state used by pre_validate_transaction, an immutable snapshot replaced on each accepted block
+struct trx_pre_validation_state {
+   chain::chain_config  config;
+   fc::time_point       head_block_time;
+};
+
+using trx_pre_validation_state_ptr = std::shared_ptr<const trx_pre_validation_state>;
+
+/// Thread safe. Checks of an input transaction that do not depend on mutable chain state. Any transaction
+/// rejected here would also be rejected by transaction_context::init_for_input_trx on the main thread.
+inline void pre_validate_transaction( const packed_transaction& ptrx, const trx_pre_validation_state& state ) {
+   using namespace eosio::chain;
+   const transaction& trx = ptrx.get_transaction();
+   EOS_ASSERT( trx.transaction_extensions.empty(), disallowed_transaction_extensions_bad_block_exception,
+               "no transaction extensions supported yet for input transactions" );
+
+   // the pending block time is always after the head block time
+   EOS_ASSERT( fc::time_point(trx.expiration) >= state.head_block_time, expired_tx_exception,
+               "transaction has expired, expiration is ${e} and head block time is ${t}",
+               ("e", trx.expiration)("t", state.head_block_time) );
+
+   bool one_auth = false;
+   for( const auto& a : trx.actions ) {
+      one_auth = one_auth || !a.authorization.empty();
+   }
+   EOS_ASSERT( one_auth, tx_no_auths, "transaction must have at least one authorization" );
+   for( const auto& a : trx.context_free_actions ) {
+      EOS_ASSERT( a.authorization.empty(), transaction_exception, "context-free actions cannot have authorizations" );
+   }
+
+   // initial net usage as calculated by transaction_context::init_for_input_trx, before block and account limits
+   const auto& cfg = state.config;
+   uint64_t discounted_size_for_pruned_data = ptrx.get_prunable_size();
+   if( cfg.context_free_discount_net_usage_den > 0
+       && cfg.context_free_discount_net_usage_num < cfg.context_free_discount_net_usage_den )
+   {
+      discounted_size_for_pruned_data *= cfg.context_free_discount_net_usage_num;
+      discounted_size_for_pruned_data =  ( discounted_size_for_pruned_data + cfg.context_free_discount_net_usage_den - 1)
+                                                                                 / cfg.context_free_discount_net_usage_den;
+   }
+   uint64_t initial_net_usage = static_cast<uint64_t>(cfg.base_per_transaction_net_usage)
+                                + ptrx.get_unprunable_size() + discounted_size_for_pruned_data;
+   if( trx.delay_sec.value > 0 ) {
+      initial_net_usage += static_cast<uint64_t>(cfg.base_per_transaction_net_usage)
+                           + static_cast<uint64_t>(config::transaction_id_net_usage);
+   }
+   uint64_t net_limit = cfg.max_transaction_net_usage;
+   uint64_t trx_specified_net_usage_limit = static_cast<uint64_t>(trx.max_net_usage_words.value) * 8;
+   if( trx_specified_net_usage_limit > 0 && trx_specified_net_usage_limit < net_limit ) {
+      net_limit = trx_specified_net_usage_limit;
+   }
+   EOS_ASSERT( initial_net_usage <= net_limit, tx_net_usage_exceeded,
+               "transaction net usage is too high: ${net_usage} > ${net_limit}",
+               ("net_usage", initial_net_usage)("net_limit", net_limit) );
+}
+
+} //eosio
@@ -1,6 +1,7 @@
 #include <eosio/producer_plugin/producer_plugin.hpp>
 #include <eosio/producer_plugin/pending_snapshot.hpp>
 #include <eosio/producer_plugin/subjective_billing.hpp>
+#include <eosio/producer_plugin/transaction_timing.hpp>
 #include <eosio/chain/plugin_interface.hpp>
 #include <eosio/chain/global_property_object.hpp>
 #include <eosio/chain/generated_transaction_object.hpp>
@@ -142,6 +143,7 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
    public:
       producer_plugin_impl(boost::asio::io_service& io)
       :_timer(io)
+      ,_speculative_restart_timer(io)
       ,_block_vault_resync(this, io)
       ,_transaction_ack_channel(app().get_channel<compat::channels::transaction_ack>())
       {
@@ -154,6 +156,7 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
       bool maybe_produce_block();
       bool remove_expired_trxs( const fc::time_point& deadline );
       bool block_is_exhausted() const;
+      bool subjective_cpu_exhausted( const account_name& first_auth, uint32_t sub_bill ) const;
       bool remove_expired_blacklisted_trxs( const fc::time_point& deadline );
       bool process_unapplied_trxs( const fc::time_point& deadline );
       void process_scheduled_and_incoming_trxs( const fc::time_point& deadline, size_t& pending_incoming_process_limit );
@@ -167,6 +170,10 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
       std::map<chain::public_key_type, signature_provider_type> _signature_providers;
       std::set<chain::account_name>                             _producers;
       boost::asio::deadline_timer                               _timer;
+      boost::asio::deadline_timer                               _speculative_restart_timer;
+      bool                                                      _speculative_restart_scheduled = false;
+      fc::microseconds                                          _speculative_block_min_age{0};
+      fc::time_point                                            _pending_block_start_time;
       block_only_sync                                           _block_vault_resync;
       using producer_watermark = std::pair<uint32_t, block_timestamp_type>;
       std::map<chain::account_name, producer_watermark>         _producer_watermarks;
@@ -201,14 +208,26 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
       incoming::methods::block_sync::method_type::handle        _incoming_block_sync_provider;
       incoming::methods::blockvault_sync::method_type::handle   _incoming_blockvault_sync_provider;
       incoming::methods::transaction_async::method_type::handle _incoming_transaction_async_provider;
+      incoming::methods::recovered_transaction_async::method_type::handle _incoming_recovered_transaction_async_provider;
 
       transaction_id_with_expiry_index                          _blacklisted_transactions;
       pending_snapshot_index                                    _pending_snapshot_index;
       subjective_billing                                        _subjective_billing;
 
+      bool                                                      _pre_validate_trxs = true;
+      // empty if not pre-validating, replaced by the main thread, read by the net_plugin via std::atomic_load
+      trx_pre_validation_state_ptr                              _trx_pre_validation_state;
+
+      bool                                                      _transaction_timing_enabled = false;
+      fc::microseconds                                          _slow_action_threshold{0}; // 0 to not log slow actions
+      transaction_timing                                        _transaction_timing;
+      std::vector<transaction_trace_ptr>                        _pending_block_traces; // added to _transaction_timing once the block is accepted
+
       std::optional<scoped_connection>                          _accepted_block_connection;
       std::optional<scoped_connection>                          _accepted_block_header_connection;
       std::optional<scoped_connection>                          _irreversible_block_connection;
+      std::optional<scoped_connection>                          _applied_transaction_connection;
+      std::optional<scoped_connection>                          _block_start_connection;
 
       /*
        * HACK ALERT
@@ -246,7 +265,16 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
          return itr->second;
       }
 
+      void update_trx_pre_validation_state() {
+         if( !_pre_validate_trxs ) return;
+         const chain::controller& chain = chain_plug->chain();
+         std::atomic_store( &_trx_pre_validation_state, std::make_shared<const trx_pre_validation_state>(
+               trx_pre_validation_state{ chain.get_global_properties().configuration, chain.head_block_time() } ) );
+      }
+
       void on_block( const block_state_ptr& bsp ) {
+         update_trx_pre_validation_state();
+         if( _transaction_timing_enabled ) on_block_accepted_timing();
          auto before = _unapplied_transactions.size();
          _unapplied_transactions.clear_applied( bsp );
          _subjective_billing.on_block( bsp, fc::time_point::now() );
@@ -254,6 +282,33 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
                   ("before", before)("after", _unapplied_transactions.size()) );
       }
 
+      // applied_transaction is also emitted for speculative executions and failed transactions,
+      // only aggregate transactions included in accepted blocks
+      void on_applied_transaction( const transaction_trace_ptr& trace ) {
+         if( _transaction_timing_enabled && !trace->except && trace->receipt )
+            _pending_block_traces.push_back( trace );
+         if( _slow_action_threshold.count() > 0 ) {
+            for( const auto& at : trace->action_traces ) {
+               if( at.elapsed >= _slow_action_threshold ) {
+                  fc_ilog( _log, "Slow action ${r} <= ${a}::${n} took ${t}us, trx: ${id}, block #${b}",
+                           ("r", at.receiver)("a", at.act.account)("n", at.act.name)("t", at.elapsed.count())
+                           ("id", trace->id)("b", trace->block_num) );
+               }
+            }
+         }
+      }
+
+      void on_block_start() {
+         // previous pending block was either accepted or aborted
+         _pending_block_traces.clear();
+      }
+
+      void on_block_accepted_timing() {
+         for( const auto& trace : _pending_block_traces )
+            _transaction_timing.add( *trace );
+         _pending_block_traces.clear();
+      }
+
       void on_block_header( const block_state_ptr& bsp ) {
          consider_new_watermark( bsp->header.producer, bsp->block_num, bsp->block->timestamp );
       }
@@ -363,7 +418,9 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
          // start processing of block
          auto bsf = chain.create_block_state_future( id, block );
 
-         // abort the pending block
+         // abort the pending block, even if the block extends its head: the block has to be applied below the
+         // pending block's undo session, and without read sets of the applied transactions there is no way to tell
+         // which of their results remain valid, so all of them are re-applied to the next speculative block
          abort_block();
 
          // exceptions throw out, make sure we restart our loop
@@ -432,6 +489,34 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
 
       void restart_speculative_block() {
          chain::controller& chain = chain_plug->chain();
+         if( _speculative_restart_scheduled ) return;
+
+         // Restarting throws away every transaction applied to the speculative block and re-applies the persisted
+         // ones, under sustained load that happens on every exhaustion. Retain a young speculative block instead,
+         // incoming transactions stay queued and are applied when the block is restarted or a new head arrives.
+         // Only restarts on the same head are avoided, a new head always aborts the block, see on_incoming_block.
+         const auto retain_until = _pending_block_start_time + _speculative_block_min_age;
+         if( chain.is_building_block() && fc::time_point::now() < retain_until ) {
+            fc_dlog( _log, "Retaining exhausted speculative block until ${t}", ("t", retain_until) );
+            _speculative_restart_scheduled = true;
+            static const boost::posix_time::ptime epoch( boost::gregorian::date( 1970, 1, 1 ) );
+            _speculative_restart_timer.expires_at( epoch + boost::posix_time::microseconds( retain_until.time_since_epoch().count() ) );
+            _speculative_restart_timer.async_wait( app().get_priority_queue().wrap( priority::high,
+               [weak_this = weak_from_this(), start_time = _pending_block_start_time]( const boost::system::error_code& ec ) {
+                  auto self = weak_this.lock();
+                  if( !self || ec == boost::asio::error::operation_aborted ) return;
+                  self->_speculative_restart_scheduled = false;
+                  // a new block was started in the meantime, it already picked up the queued transactions
+                  if( start_time != self->_pending_block_start_time || self->_pending_block_mode != pending_block_mode::speculating )
+                     return;
+                  // only restart a block that is still exhausted
+                  if( !self->chain_plug->chain().is_building_block() || !self->block_is_exhausted() )
+                     return;
+                  self->restart_speculative_block();
+               } ) );
+            return;
+         }
+
          // abort the pending block
          _unapplied_transactions.add_aborted( chain.abort_block() );
 
@@ -443,34 +528,49 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
          const auto max_trx_time_ms = _max_transaction_time_ms.load();
          fc::microseconds max_trx_cpu_usage = max_trx_time_ms < 0 ? fc::microseconds::maximum() : fc::milliseconds( max_trx_time_ms );
 
-         auto future = transaction_metadata::start_recover_keys( trx, _thread_pool->get_executor(),
-                chain.get_chain_id(), fc::microseconds( max_trx_cpu_usage ), chain.configured_subjective_signature_length_limit() );
-
-         boost::asio::post(_thread_pool->get_executor(), [self = this, future{std::move(future)}, persist_until_expired,
-                                                          next{std::move(next)}, trx]() mutable {
-            if( future.valid() ) {
-               future.wait();
-               app().post( priority::low, [self, future{std::move(future)}, persist_until_expired, next{std::move( next )}, trx{std::move(trx)}]() mutable {
-                  auto exception_handler = [&next, trx{std::move(trx)}](fc::exception_ptr ex) {
-                     fc_dlog(_trx_failed_trace_log, "[TRX_TRACE] Speculative execution is REJECTING tx: ${txid}, auth: ${a} : ${why} ",
-                            ("txid", trx->id())("a",trx->get_transaction().first_authorizer())("why",ex->what()));
-                     next(ex);
-                  };
-                  try {
-                     auto result = future.get();
-                     if( !self->process_incoming_transaction_async( result, persist_until_expired, next ) ) {
-                        if( self->_pending_block_mode == pending_block_mode::producing ) {
-                           self->schedule_maybe_produce_block( true );
-                        } else {
-                           self->restart_speculative_block();
-                        }
-                     }
-                  } CATCH_AND_CALL(exception_handler);
-               } );
-            }
+         // stateless checks and key recovery on the thread pool, keys are only recovered if the checks pass
+         boost::asio::post(_thread_pool->get_executor(), [self = this, trx, persist_until_expired, next{std::move(next)},
+                                                          pre_validation_state = _trx_pre_validation_state,
+                                                          chain_id = chain.get_chain_id(), max_trx_cpu_usage,
+                                                          max_sig_size = chain.configured_subjective_signature_length_limit()]() mutable {
+            transaction_metadata_ptr result;
+            fc::exception_ptr except;
+            auto set_except = [&except](fc::exception_ptr ex) { except = std::move( ex ); };
+            try {
+               if( pre_validation_state ) pre_validate_transaction( *trx, *pre_validation_state );
+               result = transaction_metadata::recover_keys( trx, chain_id, max_trx_cpu_usage, max_sig_size );
+            } CATCH_AND_CALL(set_except);
+
+            app().post( priority::low, [self, result{std::move(result)}, except{std::move(except)},
+                                        persist_until_expired, next{std::move( next )}, trx{std::move(trx)}]() mutable {
+               auto exception_handler = [&next, trx{std::move(trx)}](fc::exception_ptr ex) {
+                  fc_dlog(_trx_failed_trace_log, "[TRX_TRACE] Speculative execution is REJECTING tx: ${txid}, auth: ${a} : ${why} ",
+                         ("txid", trx->id())("a",trx->get_transaction().first_authorizer())("why",ex->what()));
+                  next(ex);
+               };
+               if( except ) {
+                  exception_handler( except );
+                  return;
+               }
+               try {
+                  self->on_incoming_recovered_transaction( result, persist_until_expired, next );
+               } CATCH_AND_CALL(exception_handler);
+            } );
          });
       }
 
+      // called from main thread with keys already recovered, callers run pre_validate_transaction before recovering
+      // the keys using producer_plugin::get_trx_pre_validation_state()
+      void on_incoming_recovered_transaction(const transaction_metadata_ptr& trx, bool persist_until_expired, next_function<transaction_trace_ptr> next) {
+         if( !process_incoming_transaction_async( trx, persist_until_expired, std::move( next ) ) ) {
+            if( _pending_block_mode == pending_block_mode::producing ) {
+               schedule_maybe_produce_block( true );
+            } else {
+               restart_speculative_block();
+            }
+         }
+      }
+
       bool process_incoming_transaction_async(const transaction_metadata_ptr& trx, bool persist_until_expired, next_function<transaction_trace_ptr> next) {
          bool exhausted = false;
          chain::controller& chain = chain_plug->chain();
@@ -550,6 +650,14 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
             if( !disable_subjective_billing )
                sub_bill = _subjective_billing.get_subjective_bill( first_auth, fc::time_point::now() );
 
+            if( sub_bill > 0 && subjective_cpu_exhausted( first_auth, sub_bill ) ) {
+               // would fail in transaction init anyway, avoid the cost of starting the transaction
+               send_response( std::static_pointer_cast<fc::exception>( std::make_shared<tx_cpu_usage_exceeded>(
+                     FC_LOG_MESSAGE( error, "transaction ${id} rejected, subjective CPU bill of ${a} ${b}us exceeds its available CPU",
+                                     ("id", id)("a", first_auth)("b", sub_bill) ) ) ) );
+               return true;
+            }
+
             auto trace = chain.push_transaction( trx, deadline, trx->billed_cpu_time_us, false, sub_bill );
             fc_dlog( _trx_failed_trace_log, "Subjective bill for ${a}: ${b} elapsed ${t}us", ("a",first_auth)("b",sub_bill)("t",trace->elapsed));
             if( trace->except ) {
@@ -711,10 +819,31 @@ void producer_plugin::set_program_options(
           "ratio between incoming transactions and deferred transactions when both are queued for execution")
          ("incoming-transaction-queue-size-mb", bpo::value<uint16_t>()->default_value( 1024 ),
           "Maximum size (in MiB) of the incoming transaction queue. Exceeding this value will subjectively drop transaction with resource exhaustion.")
+         ("incoming-transaction-lanes", bpo::value<string>()->default_value("none"),
+          "Group incoming transactions into lanes which are processed in weighted round-robin order instead of first-in first-out.\n"
+          "Options are: \"none\", \"first-authorizer\" and \"contract\" (account of the first action)")
+         ("incoming-transaction-lane-size-mb", bpo::value<uint16_t>()->default_value( 0 ),
+          "Maximum size (in MiB) of the incoming transactions of a single lane, 0 for no limit. Exceeding this value will subjectively drop transaction with resource exhaustion.")
+         ("incoming-transaction-lane-weight", bpo::value<vector<string>>()->composing()->multitoken(),
+          "Weight of a lane as <account>=<weight>, a lane of weight n is processed n times as often as a lane of the default weight 1. Can be specified multiple times.")
+         ("speculative-block-min-age-ms", bpo::value<uint32_t>()->default_value(0),
+          "Minimum age, in milliseconds, of an exhausted speculative block before it is aborted and restarted to apply queued incoming transactions; "
+          "younger blocks are retained and the queued transactions are applied on restart or to the next block. 0 restarts immediately. "
+          "Does not affect the abort and re-apply of all speculative transactions when a new block is received.")
+         ("incoming-transaction-pre-validation", bpo::value<bool>()->default_value(true),
+          "Reject incoming transactions that fail checks not requiring chain state (expiration, size, authorizations) on the producer thread pool before recovering their keys.")
+         ("transaction-timing", bpo::bool_switch()->default_value(false),
+          "Aggregate the time spent in each phase of transactions of produced and validated blocks and in their actions into histograms, "
+          "available from the producer API get_transaction_timing. Speculative executions are not included. Time spent in database intrinsics is only part of the exec phase.")
+         ("slow-action-threshold-us", bpo::value<uint32_t>()->default_value(0),
+          "Log actions whose execution took at least this many microseconds with their receiver, contract and action name, "
+          "including speculative executions that are re-applied later. 0 to disable.")
          ("disable-api-persisted-trx", bpo::bool_switch()->default_value(false),
           "Disable the re-apply of API transactions.")
          ("disable-subjective-billing", bpo::value<bool>()->default_value(true),
           "Disable subjective CPU billing for API/P2P transactions")
+         ("subjective-account-decay-time-minutes", bpo::value<uint32_t>()->default_value( config::account_cpu_usage_average_window_ms / 1000 / 60 ),
+          "Time in minutes over which the subjective CPU billed to an account for failed and expired transactions decays")
          ("disable-subjective-account-billing", boost::program_options::value<vector<string>>()->composing()->multitoken(),
           "Account which is excluded from subjective CPU billing")
          ("disable-subjective-p2p-billing", bpo::value<bool>()->default_value(true),
@@ -853,9 +982,43 @@ void producer_plugin::plugin_initialize(const boost::program_options::variables_
 
    my->_unapplied_transactions.set_max_transaction_queue_size( max_incoming_transaction_queue_size );
 
+   {
+      const auto& lanes_str = options.at( "incoming-transaction-lanes" ).as<string>();
+      chain::trx_lane_type lane_type = chain::trx_lane_type::none;
+      if( lanes_str == "first-authorizer" ) {
+         lane_type = chain::trx_lane_type::first_authorizer;
+      } else if( lanes_str == "contract" ) {
+         lane_type = chain::trx_lane_type::contract;
+      } else {
+         EOS_ASSERT( lanes_str == "none", plugin_config_exception,
+                     "incoming-transaction-lanes ${l} is not one of: none, first-authorizer, contract", ("l", lanes_str) );
+      }
+      std::map<account_name, uint32_t> lane_weights;
+      if( options.count( "incoming-transaction-lane-weight" ) ) {
+         for( const auto& w : options["incoming-transaction-lane-weight"].as<std::vector<std::string>>() ) {
+            auto delim = w.find( "=" );
+            EOS_ASSERT( delim != std::string::npos, plugin_config_exception,
+                        "Missing \"=\" in incoming-transaction-lane-weight ${w}", ("w", w) );
+            try {
+               uint32_t weight = std::stoul( w.substr( delim + 1 ) );
+               EOS_ASSERT( weight > 0, plugin_config_exception, "incoming-transaction-lane-weight ${w} must be greater than 0", ("w", w) );
+               lane_weights[account_name( w.substr( 0, delim ) )] = weight;
+            } catch( const std::logic_error& ) {
+               EOS_THROW( plugin_config_exception, "Invalid incoming-transaction-lane-weight ${w}", ("w", w) );
+            }
+         }
+      }
+      uint64_t max_lane_size = options.at( "incoming-transaction-lane-size-mb" ).as<uint16_t>() * 1024*1024;
+      my->_unapplied_transactions.set_lanes( lane_type, max_lane_size, std::move( lane_weights ) );
+   }
+
    my->_incoming_defer_ratio = options.at("incoming-defer-ratio").as<double>();
 
    my->_disable_persist_until_expired = options.at("disable-api-persisted-trx").as<bool>();
+   my->_pre_validate_trxs = options.at("incoming-transaction-pre-validation").as<bool>();
+   my->_speculative_block_min_age = fc::milliseconds( options.at("speculative-block-min-age-ms").as<uint32_t>() );
+   my->_transaction_timing_enabled = options.at("transaction-timing").as<bool>();
+   my->_slow_action_threshold = fc::microseconds( options.at("slow-action-threshold-us").as<uint32_t>() );
    bool disable_subjective_billing = options.at("disable-subjective-billing").as<bool>();
    my->_disable_subjective_p2p_billing = options.at("disable-subjective-p2p-billing").as<bool>();
    my->_disable_subjective_api_billing = options.at("disable-subjective-api-billing").as<bool>();
@@ -929,6 +1092,11 @@ void producer_plugin::plugin_initialize(const boost::program_options::variables_
       return my->on_incoming_transaction_async(trx, persist_until_expired, next );
    });
 
+   my->_incoming_recovered_transaction_async_provider = app().get_method<incoming::methods::recovered_transaction_async>().register_provider(
+         [this](const transaction_metadata_ptr& trx, bool persist_until_expired, next_function<transaction_trace_ptr> next) -> void {
+      return my->on_incoming_recovered_transaction(trx, persist_until_expired, next );
+   });
+
    if (options.count("greylist-account")) {
       std::vector<std::string> greylist = options["greylist-account"].as<std::vector<std::string>>();
       greylist_params param;
@@ -943,6 +1111,9 @@ void producer_plugin::plugin_initialize(const boost::program_options::variables_
       chain.set_greylist_limit( greylist_limit );
    }
 
+   my->_subjective_billing.set_expired_accumulator_average_window(
+         fc::minutes( options.at( "subjective-account-decay-time-minutes" ).as<uint32_t>() ) );
+
    if( options.count("disable-subjective-account-billing") ) {
       std::vector<std::string> accounts = options["disable-subjective-account-billing"].as<std::vector<std::string>>();
       for( const auto& a : accounts ) {
@@ -972,6 +1143,16 @@ void producer_plugin::plugin_startup()
    my->_accepted_block_connection.emplace(chain.accepted_block.connect( [this]( const auto& bsp ){ my->on_block( bsp ); } ));
    my->_accepted_block_header_connection.emplace(chain.accepted_block_header.connect( [this]( const auto& bsp ){ my->on_block_header( bsp ); } ));
    my->_irreversible_block_connection.emplace(chain.irreversible_block.connect( [this]( const auto& bsp ){ my->on_irreversible_block( bsp->block ); } ));
+   if( my->_transaction_timing_enabled || my->_slow_action_threshold.count() > 0 ) {
+      my->_applied_transaction_connection.emplace(chain.applied_transaction.connect(
+            [this]( std::tuple<const transaction_trace_ptr&, const packed_transaction_ptr&> t ) {
+               my->on_applied_transaction( std::get<0>( t ) );
+            } ));
+   }
+   if( my->_transaction_timing_enabled ) {
+      my->_block_start_connection.emplace(chain.block_start.connect( [this]( uint32_t ){ my->on_block_start(); } ));
+   }
+   my->update_trx_pre_validation_state();
 
    const auto lib_num = chain.last_irreversible_block_num();
    const auto lib = chain.fetch_block_by_number(lib_num);
@@ -1004,6 +1185,7 @@ void producer_plugin::plugin_startup()
 void producer_plugin::plugin_shutdown() {
    try {
       my->_timer.cancel();
+      my->_speculative_restart_timer.cancel();
       my->_block_vault_resync.cancel();
    } catch ( const std::bad_alloc& ) {
      chain_plugin::handle_bad_alloc();
@@ -1109,6 +1291,14 @@ producer_plugin::runtime_options producer_plugin::get_runtime_options() const {
    };
 }
 
+int32_t producer_plugin::get_max_transaction_time_ms() const {
+   return my->_max_transaction_time_ms.load();
+}
+
+trx_pre_validation_state_ptr producer_plugin::get_trx_pre_validation_state() const {
+   return std::atomic_load( &my->_trx_pre_validation_state );
+}
+
 void producer_plugin::add_greylist_accounts(const greylist_params& params) {
    chain::controller& chain = my->chain_plug->chain();
    for (auto &acc : params.accounts) {
@@ -1326,6 +1516,24 @@ fc::variants producer_plugin::get_supported_protocol_features( const get_support
    return results;
 }
 
+producer_plugin::incoming_transaction_lanes
+producer_plugin::get_incoming_transaction_lanes( const get_incoming_transaction_lanes_params& params ) const {
+   incoming_transaction_lanes result;
+   result.lane_type = my->_unapplied_transactions.get_lane_type();
+   result.incoming_count = my->_unapplied_transactions.incoming_size();
+   result.lanes = my->_unapplied_transactions.get_lanes( params.limit );
+   return result;
+}
+
+transaction_timing::results
+producer_plugin::get_transaction_timing( const get_transaction_timing_params& params ) {
+   EOS_ASSERT( my->_transaction_timing_enabled, plugin_config_exception, "transaction-timing is not enabled" );
+   auto result = my->_transaction_timing.get( params.limit );
+   if( params.reset )
+      my->_transaction_timing.clear();
+   return result;
+}
+
 producer_plugin::get_account_ram_corrections_result
 producer_plugin::get_account_ram_corrections( const get_account_ram_corrections_params& params ) const {
    get_account_ram_corrections_result result;
@@ -1454,6 +1662,10 @@ producer_plugin_impl::start_block_result producer_plugin_impl::start_block() {
    if( !chain_plug->accept_transactions() )
       return start_block_result::waiting_for_block;
 
+   // a scheduled speculative restart belongs to the previous pending block
+   _speculative_restart_timer.cancel();
+   _speculative_restart_scheduled = false;
+
    const auto& hbs = chain.head_block_state();
 
    if( chain.get_terminate_at_block() > 0 && chain.get_terminate_at_block() < hbs->block_num ) {
@@ -1614,6 +1826,7 @@ producer_plugin_impl::start_block_result producer_plugin_impl::start_block() {
       }
 
       chain.start_block( block_time, blocks_to_confirm, features_to_activate );
+      _pending_block_start_time = now;
    } LOG_AND_DROP();
 
    if( chain.is_building_block() ) {
@@ -1840,7 +2053,7 @@ bool producer_plugin_impl::process_unapplied_trxs( const fc::time_point& deadlin
       account_failures account_fails;
       chain::controller& chain = chain_plug->chain();
       const auto& rl = chain.get_resource_limits_manager();
-      int num_applied = 0, num_failed = 0, num_processed = 0;
+      int num_applied = 0, num_failed = 0, num_skipped = 0, num_processed = 0;
       auto unapplied_trxs_size = _unapplied_transactions.size();
       // unapplied and persisted do not have a next method to call
       auto itr     = (_pending_block_mode == pending_block_mode::producing) ?
@@ -1866,6 +2079,16 @@ bool producer_plugin_impl::process_unapplied_trxs( const fc::time_point& deadlin
                continue;
             }
 
+            if( _pending_block_mode == pending_block_mode::speculating && !_disable_subjective_api_billing ) {
+               const uint32_t sub_bill = _subjective_billing.get_subjective_bill( first_auth, start );
+               if( sub_bill > 0 && subjective_cpu_exhausted( first_auth, sub_bill ) ) {
+                  // same early reject as process_incoming_transaction_async, keep it to retry once the bill decays
+                  ++num_skipped;
+                  ++itr;
+                  continue;
+               }
+            }
+
             auto prev_billed_cpu_time_us = trx->billed_cpu_time_us;
             if(!_subjective_billing.is_disabled() && prev_billed_cpu_time_us > 0 && !rl.is_unlimited_cpu( first_auth )) {
                auto prev_billed_plus100 = prev_billed_cpu_time_us + EOS_PERCENT( prev_billed_cpu_time_us, 100 * config::percent_1 );
@@ -1923,8 +2146,9 @@ bool producer_plugin_impl::process_unapplied_trxs( const fc::time_point& deadlin
          ++itr;
       }
 
-      fc_dlog( _log, "Processed ${m} of ${n} previously applied transactions, Applied ${applied}, Failed/Dropped ${failed}",
-               ("m", num_processed)( "n", unapplied_trxs_size )("applied", num_applied)("failed", num_failed) );
+      fc_dlog( _log, "Processed ${m} of ${n} previously applied transactions, Applied ${applied}, Failed/Dropped ${failed}, "
+               "Skipped subjectively exhausted ${skipped}",
+               ("m", num_processed)( "n", unapplied_trxs_size )("applied", num_applied)("failed", num_failed)("skipped", num_skipped) );
       account_fails.report();
    }
    return !exhausted;
@@ -1942,8 +2166,6 @@ void producer_plugin_impl::process_scheduled_and_incoming_trxs( const fc::time_p
    auto& blacklist_by_id = _blacklisted_transactions.get<by_id>();
    chain::controller& chain = chain_plug->chain();
    time_point pending_block_time = chain.pending_block_time();
-   auto itr = _unapplied_transactions.incoming_begin();
-   auto end = _unapplied_transactions.incoming_end();
    const auto& sch_idx = chain.db().get_index<generated_transaction_multi_index,by_delay>();
    const auto scheduled_trxs_size = sch_idx.size();
    auto sch_itr = sch_idx.begin();
@@ -1973,19 +2195,21 @@ void producer_plugin_impl::process_scheduled_and_incoming_trxs( const fc::time_p
       num_processed++;
 
       // configurable ratio of incoming txns vs deferred txns
-      while (incoming_trx_weight >= 1.0 && pending_incoming_process_limit && itr != end ) {
+      while (incoming_trx_weight >= 1.0 && pending_incoming_process_limit ) {
          if (deadline <= fc::time_point::now()) {
             exhausted = true;
             break;
          }
 
+         auto itr = _unapplied_transactions.next_incoming();
+         if( itr == _unapplied_transactions.incoming_end() ) break;
          --pending_incoming_process_limit;
          incoming_trx_weight -= 1.0;
 
          auto trx_meta = itr->trx_meta;
          auto next = itr->next;
          bool persist_until_expired = itr->trx_type == trx_enum_type::incoming_persisted;
-         itr = _unapplied_transactions.erase( itr );
+         _unapplied_transactions.erase( itr );
          if( !process_incoming_transaction_async( trx_meta, persist_until_expired, next ) ) {
             exhausted = true;
             break;
@@ -2043,18 +2267,18 @@ bool producer_plugin_impl::process_incoming_trxs( const fc::time_point& deadline
    if( pending_incoming_process_limit ) {
       size_t processed = 0;
       fc_dlog( _log, "Processing ${n} pending transactions", ("n", pending_incoming_process_limit) );
-      auto itr = _unapplied_transactions.incoming_begin();
-      auto end = _unapplied_transactions.incoming_end();
-      while( pending_incoming_process_limit && itr != end ) {
+      while( pending_incoming_process_limit ) {
          if (deadline <= fc::time_point::now()) {
             exhausted = true;
             break;
          }
+         auto itr = _unapplied_transactions.next_incoming();
+         if( itr == _unapplied_transactions.incoming_end() ) break;
          --pending_incoming_process_limit;
          auto trx_meta = itr->trx_meta;
          auto next = itr->next;
          bool persist_until_expired = itr->trx_type == trx_enum_type::incoming_persisted;
-         itr = _unapplied_transactions.erase( itr );
+         _unapplied_transactions.erase( itr );
          ++processed;
          if( !process_incoming_transaction_async( trx_meta, persist_until_expired, next ) ) {
             exhausted = true;
@@ -2066,6 +2290,14 @@ bool producer_plugin_impl::process_incoming_trxs( const fc::time_point& deadline
    return !exhausted;
 }
 
+bool producer_plugin_impl::subjective_cpu_exhausted( const account_name& first_auth, uint32_t sub_bill ) const {
+   const chain::controller& chain = chain_plug->chain();
+   const auto cpu_limit = chain.get_resource_limits_manager().get_account_cpu_limit( first_auth ).first;
+   if( cpu_limit < 0 ) return false; // unlimited
+   const auto leeway = chain.get_subjective_cpu_leeway().value_or( fc::microseconds( config::default_subjective_cpu_leeway_us ) );
+   return sub_bill > cpu_limit + leeway.count();
+}
+
 bool producer_plugin_impl::block_is_exhausted() const {
    const chain::controller& chain = chain_plug->chain();
    const auto& rl = chain.get_resource_limits_manager();
@@ -158,6 +158,17 @@ BOOST_AUTO_TEST_CASE( subjective_bill_test ) {
       BOOST_CHECK_EQUAL( 0, sub_bill.get_subjective_bill(b, endtime) );
    }
 
+   { // configurable decay window, failures decay over half of the default window
+      subjective_billing sub_bill;
+      sub_bill.set_expired_accumulator_average_window( halftime - now );
+      const auto quartertime = now + fc::milliseconds(subjective_billing::expired_accumulator_average_window * subjective_billing::subjective_time_interval_ms / 4);
+
+      sub_bill.subjective_bill_failure(a, fc::microseconds(1024), now);
+      BOOST_CHECK_EQUAL( 1024, sub_bill.get_subjective_bill(a, now) );
+      BOOST_CHECK_EQUAL( 512, sub_bill.get_subjective_bill(a, quartertime) );
+      BOOST_CHECK_EQUAL( 0, sub_bill.get_subjective_bill(a, halftime) );
+   }
+
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,90 @@
+#define BOOST_TEST_MODULE transaction_timing
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/producer_plugin/transaction_timing.hpp>
+
+#include <eosio/testing/tester.hpp>
+
+namespace {
+
+using namespace eosio;
+using namespace eosio::chain;
+
+transaction_trace make_trace( std::vector<std::tuple<account_name, account_name, action_name, int64_t>> actions ) {
+   transaction_trace trace;
+   trace.phase_times.init = fc::microseconds( 3 );
+   trace.phase_times.auth = fc::microseconds( 0 );
+   trace.phase_times.exec = fc::microseconds( 100 );
+   trace.phase_times.finalize = fc::microseconds( 1 );
+   trace.phase_times.wasm_instantiation = fc::microseconds( 40 );
+   trace.elapsed = fc::microseconds( 104 );
+   for( const auto& a : actions ) {
+      action_trace at;
+      at.receiver = std::get<0>( a );
+      at.act.account = std::get<1>( a );
+      at.act.name = std::get<2>( a );
+      at.elapsed = fc::microseconds( std::get<3>( a ) );
+      trace.action_traces.push_back( std::move( at ) );
+   }
+   return trace;
+}
+
+BOOST_AUTO_TEST_SUITE( transaction_timing_test )
+
+BOOST_AUTO_TEST_CASE( histogram_test ) {
+   timing_histogram h;
+   h.add( fc::microseconds( 0 ) );
+   h.add( fc::microseconds( 1 ) );
+   h.add( fc::microseconds( 3 ) );
+   h.add( fc::microseconds( 4 ) );
+   h.add( fc::microseconds( -5 ) );
+   h.add( fc::microseconds( int64_t(1) << 40 ) );
+
+   BOOST_CHECK_EQUAL( h.count, 6u );
+   BOOST_CHECK_EQUAL( h.max_us, uint64_t(1) << 40 );
+   BOOST_CHECK_EQUAL( h.total_us, 8u + (uint64_t(1) << 40) );
+   BOOST_CHECK_EQUAL( h.buckets[0], 2u ); // 0 and negative
+   BOOST_CHECK_EQUAL( h.buckets[1], 1u ); // [1, 2)
+   BOOST_CHECK_EQUAL( h.buckets[2], 1u ); // [2, 4)
+   BOOST_CHECK_EQUAL( h.buckets[3], 1u ); // [4, 8)
+   BOOST_CHECK_EQUAL( h.buckets[timing_histogram::num_buckets - 1], 1u );
+}
+
+BOOST_AUTO_TEST_CASE( aggregate_test ) {
+   transaction_timing timing;
+   auto r = timing.get( 10 );
+   BOOST_CHECK_EQUAL( r.total.count, 0u );
+   BOOST_CHECK( r.actions.empty() );
+
+   timing.add( make_trace( { {"a"_n, "a"_n, "transfer"_n, 10}, {"b"_n, "a"_n, "transfer"_n, 20} } ) );
+   timing.add( make_trace( { {"a"_n, "a"_n, "transfer"_n, 50} } ) );
+   timing.add( make_trace( { {"c"_n, "c"_n, "heavy"_n, 70} } ) );
+
+   r = timing.get( 10 );
+   BOOST_CHECK( r.since != fc::time_point() );
+   BOOST_CHECK_EQUAL( r.total.count, 3u );
+   BOOST_CHECK_EQUAL( r.exec.total_us, 300u );
+   BOOST_CHECK_EQUAL( r.wasm_instantiation.total_us, 120u );
+   BOOST_CHECK_EQUAL( r.action.count, 4u );
+   BOOST_CHECK_EQUAL( r.action.max_us, 70u );
+   BOOST_REQUIRE_EQUAL( r.actions.size(), 3u );
+   BOOST_CHECK_EQUAL( r.actions[0].receiver, "c"_n );
+   BOOST_CHECK_EQUAL( r.actions[1].receiver, "a"_n );
+   BOOST_CHECK_EQUAL( r.actions[1].elapsed.count, 2u );
+   BOOST_CHECK_EQUAL( r.actions[1].elapsed.total_us, 60u );
+   BOOST_CHECK_EQUAL( r.actions[2].receiver, "b"_n );
+
+   r = timing.get( 1 );
+   BOOST_REQUIRE_EQUAL( r.actions.size(), 1u );
+   BOOST_CHECK_EQUAL( r.actions[0].action, "heavy"_n );
+
+   timing.clear();
+   r = timing.get( 10 );
+   BOOST_CHECK_EQUAL( r.total.count, 0u );
+   BOOST_CHECK( r.since == fc::time_point() );
+   BOOST_CHECK( r.actions.empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,91 @@
+#define BOOST_TEST_MODULE trx_pre_validation
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/producer_plugin/trx_pre_validation.hpp>
+#include <eosio/chain/transaction_metadata.hpp>
+
+#include <eosio/testing/tester.hpp>
+
+namespace {
+
+using namespace eosio;
+using namespace eosio::chain;
+
+const chain_id_type chain_id = sha256::hash( "chain" );
+const fc::time_point head_block_time = fc::time_point::from_iso_string( "2020-01-01T00:00:00" );
+
+trx_pre_validation_state make_state() {
+   trx_pre_validation_state state;
+   state.config.max_transaction_net_usage = 64 * 1024;
+   state.config.base_per_transaction_net_usage = 12;
+   state.head_block_time = head_block_time;
+   return state;
+}
+
+signed_transaction make_trx( fc::time_point expiration ) {
+   signed_transaction trx;
+   trx.expiration = expiration;
+   trx.actions.emplace_back( vector<permission_level>{{"alice"_n, config::active_name}}, "eosio"_n, "nonce"_n, bytes{} );
+   return trx;
+}
+
+// as received from a peer: signed, packed and then pre-validated and recovered by the net_plugin thread pool
+packed_transaction_ptr pack( signed_transaction trx ) {
+   trx.sign( testing::base_tester::get_private_key( "alice"_n, "active" ), chain_id );
+   return std::make_shared<packed_transaction>( std::move( trx ), true );
+}
+
+transaction_metadata_ptr pre_validate_and_recover( const packed_transaction_ptr& trx, const trx_pre_validation_state& state ) {
+   pre_validate_transaction( *trx, state );
+   return transaction_metadata::recover_keys( trx, chain_id, fc::microseconds::maximum() );
+}
+
+BOOST_AUTO_TEST_SUITE( trx_pre_validation_test )
+
+BOOST_AUTO_TEST_CASE( recovered_trx_test ) {
+   const auto state = make_state();
+
+   auto ptrx = pack( make_trx( head_block_time + fc::seconds( 30 ) ) );
+   transaction_metadata_ptr trx_meta;
+   BOOST_REQUIRE_NO_THROW( trx_meta = pre_validate_and_recover( ptrx, state ) );
+   BOOST_REQUIRE( trx_meta );
+   BOOST_CHECK( trx_meta->recovered_keys().count( testing::base_tester::get_public_key( "alice"_n, "active" ) ) == 1 );
+
+   // expiring at the head block time is allowed, the pending block time decides
+   BOOST_CHECK_NO_THROW( pre_validate_and_recover( pack( make_trx( head_block_time ) ), state ) );
+
+   BOOST_CHECK_THROW( pre_validate_and_recover( pack( make_trx( head_block_time - fc::seconds( 1 ) ) ), state ), expired_tx_exception );
+
+   auto trx = make_trx( head_block_time + fc::seconds( 30 ) );
+   trx.actions.front().authorization.clear();
+   BOOST_CHECK_THROW( pre_validate_and_recover( pack( signed_transaction( trx ) ), state ), tx_no_auths );
+
+   trx = make_trx( head_block_time + fc::seconds( 30 ) );
+   trx.context_free_actions.emplace_back( vector<permission_level>{{"alice"_n, config::active_name}}, "eosio"_n, "nonce"_n, bytes{} );
+   BOOST_CHECK_THROW( pre_validate_and_recover( pack( signed_transaction( trx ) ), state ), transaction_exception );
+
+   trx = make_trx( head_block_time + fc::seconds( 30 ) );
+   trx.transaction_extensions.emplace_back( 0, vector<char>{} );
+   BOOST_CHECK_THROW( pre_validate_and_recover( pack( signed_transaction( trx ) ), state ), disallowed_transaction_extensions_bad_block_exception );
+}
+
+BOOST_AUTO_TEST_CASE( net_usage_test ) {
+   auto state = make_state();
+
+   auto trx = make_trx( head_block_time + fc::seconds( 30 ) );
+   trx.actions.front().data = bytes( 1024 );
+   auto ptrx = pack( signed_transaction( trx ) );
+   BOOST_CHECK_NO_THROW( pre_validate_transaction( *ptrx, state ) );
+
+   state.config.max_transaction_net_usage = 512;
+   BOOST_CHECK_THROW( pre_validate_transaction( *ptrx, state ), tx_net_usage_exceeded );
+
+   // the transaction's own limit applies when it is lower
+   state = make_state();
+   trx.max_net_usage_words = 64;
+   BOOST_CHECK_THROW( pre_validate_transaction( *pack( signed_transaction( trx ) ), state ), tx_net_usage_exceeded );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -109,6 +109,20 @@ struct compressed_file_impl {
       }
    }
 
+   static std::vector<seek_point_entry> read_seek_point_map( fc::cfile& file ) {
+      file.seek_end(-expected_seek_point_count_size);
+      seek_point_count_type seek_point_count = 0;
+      file.read(reinterpret_cast<char*>(&seek_point_count), sizeof(seek_point_count));
+
+      std::vector<seek_point_entry> result(seek_point_count);
+      if (seek_point_count > 0) {
+         int seek_map_size = sizeof(seek_point_entry) * seek_point_count;
+         file.seek_end(-expected_seek_point_count_size - seek_map_size);
+         file.read(reinterpret_cast<char*>(result.data()), result.size() * sizeof(seek_point_entry));
+      }
+      return result;
+   }
+
    void seek( long loc, fc::cfile& file ) {
       if (initialized) {
          inflateEnd(&strm);
@@ -117,31 +131,27 @@ struct compressed_file_impl {
 
       long remaining = loc;
 
-      // read in the seek point map
-      file.seek_end(-expected_seek_point_count_size);
-      seek_point_count_type seek_point_count = 0;
-      file.read(reinterpret_cast<char*>(&seek_point_count), sizeof(seek_point_count));
-
-      if (seek_point_count > 0) {
-         int seek_map_size = sizeof(seek_point_entry) * seek_point_count;
-         file.seek_end(-expected_seek_point_count_size - seek_map_size);
+      // the file is immutable once written so the seek point map only needs to be read once
+      if (!seek_point_map) {
+         seek_point_map = read_seek_point_map(file);
+      }
 
-         std::vector<seek_point_entry> seek_point_map(seek_point_count);
-         file.read(reinterpret_cast<char*>(seek_point_map.data()), seek_point_map.size() * sizeof(seek_point_entry));
+      if (!seek_point_map->empty()) {
+         const auto& seek_points = *seek_point_map;
 
          // seek to the neareast seek point
-         auto iter = std::lower_bound(seek_point_map.begin(), seek_point_map.end(), (uint64_t)loc, []( const auto& lhs, const auto& rhs ){
+         auto iter = std::lower_bound(seek_points.begin(), seek_points.end(), (uint64_t)loc, []( const auto& lhs, const auto& rhs ){
             return std::get<0>(lhs) < rhs;
          });
 
          // special case when there is a seek point that is exact
-         if ( iter != seek_point_map.end() && std::get<0>(*iter) == static_cast<unsigned long>(loc) ) {
+         if ( iter != seek_points.end() && std::get<0>(*iter) == static_cast<unsigned long>(loc) ) {
             file.seek(std::get<1>(*iter));
             return;
          }
 
          // special case when this is before the first seek point
-         if ( iter == seek_point_map.begin() ) {
+         if ( iter == seek_points.begin() ) {
             file.seek(0);
          } else {
             // if lower bound wasn't exact iter will be one past the seek point we need
@@ -166,6 +176,7 @@ struct compressed_file_impl {
    size_t remaining_read_buffer = 0;
    bool initialized = false;
    size_t file_size = 0;
+   std::optional<std::vector<seek_point_entry>> seek_point_map;
 };
 
 compressed_file::compressed_file( fc::path file_path )
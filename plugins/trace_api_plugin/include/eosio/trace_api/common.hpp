@@ -47,6 +47,9 @@ namespace eosio::trace_api {
    // optional block trace and irreversibility paired data
    using get_block_t = std::optional<std::tuple<data_log_entry, bool>>;
 
+   // receives each block trace of a range together with its irreversibility, in ascending block order
+   using get_blocks_callback = std::function<void(const data_log_entry&, bool)>;
+
    /**
     * Normal use case: exception_handler except_handler;
     *   except_handler( MAKE_EXCEPTION_WITH_CONTEXT( std::current_exception() ) );
@@ -12,6 +12,21 @@ namespace eosio::trace_api {
       class response_formatter {
       public:
          static fc::variant process_block( const data_log_entry& trace, bool irreversible, const data_handler_function& data_handler, const yield_function& yield );
+
+         /**
+          * Encode a block trace as JSON directly into `out` without building an intermediate fc::variant tree.
+          * The output is equivalent to `fc::json::to_string(process_block(...))`, only the decoded action data
+          * of a single action is materialized as a variant at any time. `deadline` bounds the JSON encoding of
+          * those variants.
+          */
+         static void write_block_json( std::string& out, const data_log_entry& trace, bool irreversible, const data_handler_function& data_handler, const yield_function& yield,
+                                       const fc::time_point& deadline = fc::time_point::maximum() );
+
+         /**
+          * fc::raw pack a block trace as the irreversibility flag (bool) followed by the data_log_entry.
+          * Action data is left in its binary form, no ABI decoding takes place.
+          */
+         static std::string pack_block( const data_log_entry& trace, bool irreversible );
       };
    }
 
@@ -52,6 +67,113 @@ namespace eosio::trace_api {
          return detail::response_formatter::process_block(std::get<0>(*data), std::get<1>(*data), data_handler, yield);
       }
 
+      /**
+       * Fetch the trace for a given block height and encode it directly as JSON, bypassing the fc::variant
+       * representation of the whole block.
+       *
+       * @param block_height - the height of the block whose trace is requested
+       * @param yield - a yield function to allow cooperation during long running tasks
+       * @param deadline - deadline for the JSON encoding of decoded action data
+       * @return the JSON encoded trace for the given block height if it exists, an empty optional otherwise.
+       * @throws yield_exception if a call to `yield` throws.
+       * @throws fc::timeout_exception if encoding passes `deadline`.
+       * @throws bad_data_exception when there are issues with the underlying data preventing processing.
+       */
+      std::optional<std::string> get_block_trace_json( uint32_t block_height, const yield_function& yield = {},
+                                                       const fc::time_point& deadline = fc::time_point::maximum() ) {
+         auto data = logfile_provider.get_block(block_height, yield);
+         if (!data) {
+            return {};
+         }
+
+         yield();
+
+         auto data_handler = [this](const auto& action, const yield_function& yield) -> std::tuple<fc::variant, std::optional<fc::variant>> {
+            return std::visit([&](const auto& action_trace_t) {
+               return data_handler_provider.serialize_to_variant(action_trace_t, yield);
+            }, action);
+         };
+
+         std::string result;
+         detail::response_formatter::write_block_json(result, std::get<0>(*data), std::get<1>(*data), data_handler, yield, deadline);
+         return result;
+      }
+
+      /**
+       * Fetch the trace for a given block height in the packed binary format, intended for consumers which
+       * do not need the JSON representation
+       *
+       * @param block_height - the height of the block whose trace is requested
+       * @param yield - a yield function to allow cooperation during long running tasks
+       * @return the packed irreversibility flag and trace for the given block height if it exists, an empty
+       * optional otherwise.
+       * @throws yield_exception if a call to `yield` throws.
+       * @throws bad_data_exception when there are issues with the underlying data preventing processing.
+       */
+      std::optional<std::string> get_block_trace_packed( uint32_t block_height, const yield_function& yield = {}) {
+         auto data = logfile_provider.get_block(block_height, yield);
+         if (!data) {
+            return {};
+         }
+
+         yield();
+
+         return detail::response_formatter::pack_block(std::get<0>(*data), std::get<1>(*data));
+      }
+
+      /**
+       * Fetch the traces for a contiguous range of blocks and encode them as a JSON array, blocks without a
+       * trace are omitted
+       *
+       * @param block_height - the height of the first block whose trace is requested
+       * @param count - the number of blocks in the range
+       * @param yield - a yield function to allow cooperation during long running tasks
+       * @param deadline - deadline for the JSON encoding of decoded action data
+       * @return the JSON encoded array of traces in ascending block order
+       * @throws yield_exception if a call to `yield` throws.
+       * @throws fc::timeout_exception if encoding passes `deadline`.
+       * @throws bad_data_exception when there are issues with the underlying data preventing processing.
+       */
+      std::string get_blocks_trace_json( uint32_t block_height, uint32_t count, const yield_function& yield = {},
+                                         const fc::time_point& deadline = fc::time_point::maximum() ) {
+         auto data_handler = [this](const auto& action, const yield_function& yield) -> std::tuple<fc::variant, std::optional<fc::variant>> {
+            return std::visit([&](const auto& action_trace_t) {
+               return data_handler_provider.serialize_to_variant(action_trace_t, yield);
+            }, action);
+         };
+
+         std::string result = "[";
+         bool first = true;
+         logfile_provider.get_blocks(block_height, count, [&](const data_log_entry& entry, bool irreversible) {
+            yield();
+            if (!first) result += ',';
+            first = false;
+            detail::response_formatter::write_block_json(result, entry, irreversible, data_handler, yield, deadline);
+         }, yield);
+         result += ']';
+         return result;
+      }
+
+      /**
+       * Fetch the traces for a contiguous range of blocks in the packed binary format, as a concatenation of the
+       * `get_block_trace_packed` encoding of each block, blocks without a trace are omitted
+       *
+       * @param block_height - the height of the first block whose trace is requested
+       * @param count - the number of blocks in the range
+       * @param yield - a yield function to allow cooperation during long running tasks
+       * @return the packed traces in ascending block order
+       * @throws yield_exception if a call to `yield` throws.
+       * @throws bad_data_exception when there are issues with the underlying data preventing processing.
+       */
+      std::string get_blocks_trace_packed( uint32_t block_height, uint32_t count, const yield_function& yield = {}) {
+         std::string result;
+         logfile_provider.get_blocks(block_height, count, [&](const data_log_entry& entry, bool irreversible) {
+            yield();
+            result += detail::response_formatter::pack_block(entry, irreversible);
+         }, yield);
+         return result;
+      }
+
    private:
       LogfileProvider logfile_provider;
       DataHandlerProvider data_handler_provider;
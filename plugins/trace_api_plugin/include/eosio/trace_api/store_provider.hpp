@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ios>
+#include <list>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -87,6 +88,80 @@ namespace eosio::trace_api {
    }
 
 
+   /**
+    * A bounded, thread safe pool of open read-only slice files keyed by slice number.  A handle is checked out for
+    * the exclusive use of one reader and checked back in when the reader is done with it.  Invalidating a slice
+    * closes its idle handles; handles checked out before any invalidation are closed on check in rather than
+    * returned to the pool.
+    */
+   template<typename File>
+   class slice_handle_cache {
+   public:
+      using handle = std::unique_ptr<File>;
+
+      explicit slice_handle_cache(size_t max_handles)
+      :_max_handles(max_handles)
+      {}
+
+      /**
+       * Take an idle handle for the slice out of the cache
+       *
+       * @param slice_number : slice number of the requested slice file
+       * @return a 2-tuple of the cached handle (empty if none is available) and the generation that must be
+       *         provided when checking a handle for this slice back in
+       */
+      std::tuple<handle, uint64_t> checkout(uint32_t slice_number) {
+         std::lock_guard<std::mutex> lock(_mtx);
+         auto itr = std::find_if(_idle.begin(), _idle.end(), [slice_number](const auto& e) { return e.first == slice_number; });
+         if (itr == _idle.end()) {
+            return {handle{}, _generation};
+         }
+         handle result = std::move(itr->second);
+         _idle.erase(itr);
+         return {std::move(result), _generation};
+      }
+
+      /**
+       * Return a handle to the cache, evicting the least recently returned handle if the cache is full
+       *
+       * @param slice_number : slice number the handle was opened for
+       * @param h : the open handle
+       * @param generation : the generation returned by the `checkout` preceding the use of this handle
+       */
+      void checkin(uint32_t slice_number, handle h, uint64_t generation) {
+         std::lock_guard<std::mutex> lock(_mtx);
+         if (_max_handles == 0 || generation != _generation) {
+            return;
+         }
+         _idle.emplace_front(slice_number, std::move(h));
+         if (_idle.size() > _max_handles) {
+            _idle.pop_back();
+         }
+      }
+
+      /**
+       * Close all idle handles for the slice and prevent outstanding handles from being checked back in
+       *
+       * @param slice_number : slice number whose files are about to be changed or removed
+       */
+      void invalidate(uint32_t slice_number) {
+         std::lock_guard<std::mutex> lock(_mtx);
+         ++_generation;
+         _idle.remove_if([slice_number](const auto& e) { return e.first == slice_number; });
+      }
+
+      size_t size() const {
+         std::lock_guard<std::mutex> lock(_mtx);
+         return _idle.size();
+      }
+
+   private:
+      const size_t _max_handles;
+      mutable std::mutex _mtx;
+      uint64_t _generation = 0;
+      std::list<std::pair<uint32_t, handle>> _idle; // most recently checked in first
+   };
+
    class store_provider;
 
    /**
@@ -100,8 +175,13 @@ namespace eosio::trace_api {
       };
 
       enum class open_state { read /*read from front to back*/, write /*write to end of file*/ };
+      static constexpr size_t default_max_cached_slice_handles = 32;
+
       slice_directory(const boost::filesystem::path& slice_dir, uint32_t width, std::optional<uint32_t> minimum_irreversible_history_blocks,
-                      std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride);
+                      std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride,
+                      size_t max_cached_slice_handles = default_max_cached_slice_handles,
+                      std::optional<boost::filesystem::path> archive_dir = {},
+                      std::optional<uint32_t> minimum_unarchived_irreversible_history_blocks = {});
 
       /**
        * Return the slice number that would include the passed in block_height
@@ -113,6 +193,16 @@ namespace eosio::trace_api {
          return block_height / _width;
       }
 
+      /**
+       * Return the first block height that is not part of the given slice
+       *
+       * @param slice_number : the slice number
+       * @return the block height one past the end of the slice
+       */
+      uint64_t slice_end(uint32_t slice_number) const {
+         return (static_cast<uint64_t>(slice_number) + 1) * _width;
+      }
+
       /**
        * Find or create the index file associated with the indicated slice_number
        *
@@ -162,7 +252,8 @@ namespace eosio::trace_api {
       bool find_trace_slice(uint32_t slice_number, open_state state, fc::cfile& trace_file, bool open_file = true) const;
 
       /**
-       * Find the read-only compressed trace file associated with the indicated slice_number
+       * Find the read-only compressed trace file associated with the indicated slice_number, looking in the
+       * slice directory first and then in the archive directory (if one is configured)
        *
        * @param slice_number : slice number of the requested slice file
        * @param open_file : indicate if the file should be opened (if found) or not
@@ -172,6 +263,68 @@ namespace eosio::trace_api {
        */
       std::optional<compressed_file> find_compressed_trace_slice(uint32_t slice_number, bool open_file = true) const;
 
+      /**
+       * Call `fn` with an open, read-only index file for the slice, positioned just past its header.  A cached
+       * handle is reused when available and the handle is returned to the cache once `fn` completes.
+       *
+       * @param slice_number : slice number of the requested slice file
+       * @param fn : functor/lambda taking an fc::cfile&
+       * @return true if the index file was found (and `fn` called)
+       */
+      template<typename Fn>
+      bool with_index_slice(uint32_t slice_number, Fn&& fn) const {
+         auto [index, generation] = _index_handles.checkout(slice_number);
+         if (index) {
+            index->seek(0);
+         } else {
+            index = open_read_only_slice(slice_number, true);
+            if (!index) {
+               return false;
+            }
+         }
+
+         validate_existing_index_slice_file(*index, open_state::read);
+         fn(*index);
+         _index_handles.checkin(slice_number, std::move(index), generation);
+         return true;
+      }
+
+      /**
+       * Call `fn` with an open, read-only trace file for the slice.  The uncompressed trace file is preferred,
+       * otherwise the compressed trace file is used.  A cached handle is reused when available and the handle is
+       * returned to the cache once `fn` completes.
+       *
+       * @param slice_number : slice number of the requested slice file
+       * @param fn : functor/lambda taking either an fc::cfile& or a compressed_file&
+       * @return true if either trace file was found (and `fn` called)
+       */
+      template<typename Fn>
+      bool with_trace_slice(uint32_t slice_number, Fn&& fn) const {
+         {
+            auto [trace, generation] = _trace_handles.checkout(slice_number);
+            if (!trace) {
+               trace = open_read_only_slice(slice_number, false);
+            }
+            if (trace) {
+               fn(*trace);
+               _trace_handles.checkin(slice_number, std::move(trace), generation);
+               return true;
+            }
+         }
+
+         auto [ctrace, generation] = _compressed_trace_handles.checkout(slice_number);
+         if (!ctrace) {
+            auto found = find_compressed_trace_slice(slice_number);
+            if (!found) {
+               return false;
+            }
+            ctrace = std::make_unique<compressed_file>(std::move(*found));
+         }
+         fn(*ctrace);
+         _compressed_trace_handles.checkin(slice_number, std::move(ctrace), generation);
+         return true;
+      }
+
       /**
        * Find or create a trace and index file pair
        *
@@ -201,6 +354,7 @@ namespace eosio::trace_api {
       /**
        * Cleans up all slices that are no longer needed to maintain the minimum number of blocks past lib
        * Compresses up all slices that can be compressed
+       * Moves all compressed slices that can be archived to the archive directory
        *
        * @param lib : block number of the current lib
        */
@@ -211,6 +365,12 @@ namespace eosio::trace_api {
       // the slice_prefix and slice_number, but will only be opened if found
       bool find_slice(const char* slice_prefix, uint32_t slice_number, fc::cfile& slice_file, bool open_file) const;
 
+      // open the index (or uncompressed trace) file for reading only, returns an empty pointer if it does not exist
+      std::unique_ptr<fc::cfile> open_read_only_slice(uint32_t slice_number, bool index) const;
+
+      // close any cached handles to the files of a slice before they are changed or removed
+      void invalidate_cached_slice(uint32_t slice_number);
+
       // take an index file that is initialized to a file and open it and write its header
       void create_new_index_slice_file(fc::cfile& index_file) const;
 
@@ -228,6 +388,13 @@ namespace eosio::trace_api {
       const std::optional<uint32_t> _minimum_uncompressed_irreversible_history_blocks;
       std::optional<uint32_t> _last_compressed_slice;
       const size_t _compression_seek_point_stride;
+      const std::optional<boost::filesystem::path> _archive_dir;
+      const std::optional<uint32_t> _minimum_unarchived_irreversible_history_blocks;
+      std::optional<uint32_t> _last_archived_slice;
+
+      mutable slice_handle_cache<fc::cfile> _index_handles;
+      mutable slice_handle_cache<fc::cfile> _trace_handles;
+      mutable slice_handle_cache<compressed_file> _compressed_trace_handles;
 
       std::atomic<uint32_t> _best_known_lib{0};
       std::mutex _maintenance_mtx;
@@ -244,7 +411,10 @@ namespace eosio::trace_api {
       using open_state = slice_directory::open_state;
 
       store_provider(const boost::filesystem::path& slice_dir, uint32_t stride_width, std::optional<uint32_t> minimum_irreversible_history_blocks,
-            std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride);
+            std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride,
+            size_t max_cached_slice_handles = slice_directory::default_max_cached_slice_handles,
+            std::optional<boost::filesystem::path> archive_dir = {},
+            std::optional<uint32_t> minimum_unarchived_irreversible_history_blocks = {});
 
       template<typename BlockTrace>
       void append(const BlockTrace& bt);
@@ -258,6 +428,16 @@ namespace eosio::trace_api {
        */
       get_block_t get_block(uint32_t block_height, const yield_function& yield= {});
 
+      /**
+       * Read the traces for a contiguous range of blocks.  Each slice touched by the range has its index scanned
+       * once and its trace file opened once, entries are then read front-to-back.  Blocks without a trace are
+       * skipped.
+       * @param block_height : the height of the first block being read
+       * @param count : the number of blocks in the range
+       * @param fn : called with each block trace and a flag indicating irreversibility, in ascending block order
+       */
+      void get_blocks(uint32_t block_height, uint32_t count, const get_blocks_callback& fn, const yield_function& yield= {});
+
       void start_maintenance_thread( log_handler log ) {
          _slice_directory.start_maintenance_thread( std::move(log) );
       }
@@ -280,24 +460,22 @@ namespace eosio::trace_api {
       uint64_t scan_metadata_log_from( uint32_t block_height, uint64_t offset, Fn&& fn, const yield_function& yield ) {
          // ignoring offset
          offset = 0;
-         fc::cfile index;
+         uint64_t last_read_offset = 0;
          const uint32_t slice_number = _slice_directory.slice_number(block_height);
-         const bool found = _slice_directory.find_index_slice(slice_number, open_state::read, index);
-         if( !found ) {
-            return 0;
-         }
-         const uint64_t end = file_size(index.get_file_path());
-         offset = index.tellp();
-         uint64_t last_read_offset = offset;
-         while (offset < end) {
-            yield();
-            const auto metadata = extract_store<metadata_log_entry>(index);
-            if(! fn(metadata)) {
-               break;
-            }
-            last_read_offset = offset;
+         _slice_directory.with_index_slice(slice_number, [&](fc::cfile& index) {
+            const uint64_t end = file_size(index.get_file_path());
             offset = index.tellp();
-         }
+            last_read_offset = offset;
+            while (offset < end) {
+               yield();
+               const auto metadata = extract_store<metadata_log_entry>(index);
+               if(! fn(metadata)) {
+                  break;
+               }
+               last_read_offset = offset;
+               offset = index.tellp();
+            }
+         });
          return last_read_offset;
       }
 
@@ -312,28 +490,70 @@ namespace eosio::trace_api {
       std::optional<data_log_entry> read_data_log( uint32_t block_height, uint64_t offset ) {
          const uint32_t slice_number = _slice_directory.slice_number(block_height);
 
-         fc::cfile trace;
-         if( !_slice_directory.find_trace_slice(slice_number, open_state::read, trace) ) {
-            // attempt to read a compressed trace if one exists
-            std::optional<compressed_file> ctrace = _slice_directory.find_compressed_trace_slice(slice_number);
-            if (ctrace) {
-               ctrace->seek(offset);
-               return extract_store<data_log_entry>(*ctrace);
+         std::optional<data_log_entry> result;
+         const bool found = _slice_directory.with_trace_slice(slice_number, [&](auto& trace) {
+            // attempt to read a compressed trace if no uncompressed trace exists
+            if constexpr (std::is_same_v<std::decay_t<decltype(trace)>, fc::cfile>) {
+               const uint64_t end = file_size(trace.get_file_path());
+               if( offset >= end ) {
+                  const std::string offset_str = boost::lexical_cast<std::string>(offset);
+                  const std::string bh_str = boost::lexical_cast<std::string>(block_height);
+                  const std::string end_str = boost::lexical_cast<std::string>(end);
+                  throw malformed_slice_file("Requested offset: " + offset_str + " to retrieve block number: " + bh_str + " but this trace file only goes to offset: " + end_str);
+               }
             }
+            trace.seek(offset);
+            result = extract_store<data_log_entry>(trace);
+         });
 
+         if (!found) {
             const std::string offset_str = boost::lexical_cast<std::string>(offset);
             const std::string bh_str = boost::lexical_cast<std::string>(block_height);
             throw malformed_slice_file("Requested offset: " + offset_str + " to retrieve block number: " + bh_str + " but this trace file is new, so there are no traces present.");
          }
-         const uint64_t end = file_size(trace.get_file_path());
-         if( offset >= end ) {
-            const std::string offset_str = boost::lexical_cast<std::string>(offset);
-            const std::string bh_str = boost::lexical_cast<std::string>(block_height);
-            const std::string end_str = boost::lexical_cast<std::string>(end);
-            throw malformed_slice_file("Requested offset: " + offset_str + " to retrieve block number: " + bh_str + " but this trace file only goes to offset: " + end_str);
+         return result;
+      }
+
+      /**
+       * Read a set of entries from the data log of a single slice, opening the slice only once
+       * @param slice_number : the slice containing all the entries
+       * @param offsets : the offsets in the datalog to read, ordered by block height
+       * @param fn : the functor/lambda receiving each entry
+       * @throws std::exception : when the data is not the correct type or if the log is corrupt in some way
+       */
+      template<typename Fn>
+      void read_data_log_entries( uint32_t slice_number, const std::vector<uint64_t>& offsets, Fn&& fn, const yield_function& yield ) {
+         // avoid re-seeking when entries are consecutive, a seek in a compressed file restarts decompression
+         auto read_all = [&](auto& file) {
+            std::optional<uint64_t> position;
+            for (const auto offset : offsets) {
+               yield();
+               if (!position || *position != offset) {
+                  file.seek(offset);
+               }
+               auto entry = extract_store<data_log_entry>(file);
+               position = offset + fc::raw::pack_size(entry);
+               fn(entry);
+            }
+         };
+
+         const bool found = _slice_directory.with_trace_slice(slice_number, [&](auto& trace) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(trace)>, fc::cfile>) {
+               const uint64_t end = file_size(trace.get_file_path());
+               const auto max_offset = std::max_element(offsets.begin(), offsets.end());
+               if( max_offset != offsets.end() && *max_offset >= end ) {
+                  const std::string offset_str = boost::lexical_cast<std::string>(*max_offset);
+                  const std::string end_str = boost::lexical_cast<std::string>(end);
+                  throw malformed_slice_file("Requested offset: " + offset_str + " but this trace file only goes to offset: " + end_str);
+               }
+            }
+            read_all(trace);
+         });
+
+         if (!found) {
+            const std::string sn_str = boost::lexical_cast<std::string>(slice_number);
+            throw malformed_slice_file("Requested entries from slice: " + sn_str + " but this trace file is new, so there are no traces present.");
          }
-         trace.seek(offset);
-         return extract_store<data_log_entry>(trace);
       }
 
       /**
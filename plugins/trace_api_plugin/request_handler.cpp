@@ -3,6 +3,8 @@
 #include <algorithm>
 
 #include <fc/variant_object.hpp>
+#include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
 
 namespace {
    using namespace eosio::trace_api;
@@ -27,19 +29,23 @@ namespace {
 
    }
 
+   // create a vector of indices to sort based on actions to avoid copies
    template<typename ActionTrace>
-   fc::variants process_actions(const std::vector<ActionTrace>& actions, const data_handler_function & data_handler,  const yield_function& yield ) {
-      fc::variants result;
-      result.reserve(actions.size());
-
-      // create a vector of indices to sort based on actions to avoid copies
+   std::vector<int> sorted_action_indices(const std::vector<ActionTrace>& actions) {
       std::vector<int> indices(actions.size());
       std::iota(indices.begin(), indices.end(), 0);
       std::sort(indices.begin(), indices.end(), [&actions](const int& lhs, const int& rhs) -> bool {
          return actions.at(lhs).global_sequence < actions.at(rhs).global_sequence;
       });
+      return indices;
+   }
 
-      for ( int index : indices) {
+   template<typename ActionTrace>
+   fc::variants process_actions(const std::vector<ActionTrace>& actions, const data_handler_function & data_handler,  const yield_function& yield ) {
+      fc::variants result;
+      result.reserve(actions.size());
+
+      for ( int index : sorted_action_indices(actions)) {
          yield();
 
          const auto& a = actions.at(index);
@@ -119,6 +125,150 @@ namespace {
    }
 }
 
+namespace {
+   using namespace eosio::trace_api;
+
+   /*
+    * Helpers for encoding JSON directly to a string.  Keys, names, checksums and timestamps are known to only
+    * contain characters which do not require escaping.  Anything with a less constrained representation is
+    * routed through fc::json so the output is identical to serializing the equivalent fc::variant.
+    */
+   void write_key(std::string& out, const char* key) {
+      out += '"';
+      out += key;
+      out += "\":";
+   }
+
+   void write_plain_string(std::string& out, const std::string& value) {
+      out += '"';
+      out += value;
+      out += '"';
+   }
+
+   void write_variant(std::string& out, const fc::variant& value, const fc::time_point& deadline) {
+      out += fc::json::to_string(value, deadline);
+   }
+
+   void write_hex(std::string& out, const std::vector<char>& data) {
+      write_plain_string(out, fc::to_hex(data.data(), data.size()));
+   }
+
+   void write_authorizations(std::string& out, const std::vector<authorization_trace_v0>& authorizations, const yield_function& yield) {
+      out += '[';
+      bool first = true;
+      for ( const auto& a: authorizations) {
+         yield();
+         if (!first) out += ',';
+         first = false;
+
+         out += '{';
+         write_key(out, "account");
+         write_plain_string(out, a.account.to_string());
+         out += ',';
+         write_key(out, "permission");
+         write_plain_string(out, a.permission.to_string());
+         out += '}';
+      }
+      out += ']';
+   }
+
+   template<typename ActionTrace>
+   void write_actions(std::string& out, const std::vector<ActionTrace>& actions, const data_handler_function& data_handler, const yield_function& yield, const fc::time_point& deadline) {
+      out += '[';
+      bool first = true;
+      for ( int index : sorted_action_indices(actions)) {
+         yield();
+         if (!first) out += ',';
+         first = false;
+
+         const auto& a = actions.at(index);
+         out += '{';
+         write_key(out, "global_sequence");
+         write_variant(out, fc::variant(a.global_sequence), deadline);
+         out += ',';
+         write_key(out, "receiver");
+         write_plain_string(out, a.receiver.to_string());
+         out += ',';
+         write_key(out, "account");
+         write_plain_string(out, a.account.to_string());
+         out += ',';
+         write_key(out, "action");
+         write_plain_string(out, a.action.to_string());
+         out += ',';
+         write_key(out, "authorization");
+         write_authorizations(out, a.authorization, yield);
+         out += ',';
+         write_key(out, "data");
+         write_hex(out, a.data);
+
+         if constexpr(std::is_same_v<ActionTrace, action_trace_v1>){
+            out += ',';
+            write_key(out, "return_value");
+            write_hex(out, a.return_value);
+         }
+
+         // decoded data is materialized one action at a time and released as soon as it is written
+         auto [params, return_data] = data_handler(a, yield);
+         if (!params.is_null()) {
+            out += ',';
+            write_key(out, "params");
+            write_variant(out, params, deadline);
+         }
+         if constexpr(std::is_same_v<ActionTrace, action_trace_v1>){
+            if (return_data.has_value()) {
+               out += ',';
+               write_key(out, "return_data");
+               write_variant(out, *return_data, deadline);
+            }
+         }
+         out += '}';
+      }
+      out += ']';
+   }
+
+   template<typename TransactionTrace>
+   void write_transactions(std::string& out, const std::vector<TransactionTrace>& transactions, const data_handler_function& data_handler, const yield_function& yield, const fc::time_point& deadline) {
+      out += '[';
+      bool first = true;
+      for ( const auto& t: transactions) {
+         yield();
+         if (!first) out += ',';
+         first = false;
+
+         out += '{';
+         write_key(out, "id");
+         write_plain_string(out, t.id.str());
+         out += ',';
+         write_key(out, "actions");
+         if constexpr(std::is_same_v<TransactionTrace, transaction_trace_v2>){
+            write_actions<action_trace_v1>(out, std::get<std::vector<action_trace_v1>>(t.actions), data_handler, yield, deadline);
+         } else {
+            write_actions<action_trace_v0>(out, t.actions, data_handler, yield, deadline);
+         }
+
+         if constexpr(!std::is_same_v<TransactionTrace, transaction_trace_v0>){
+            out += ',';
+            write_key(out, "status");
+            write_variant(out, fc::variant(t.status), deadline);
+            out += ',';
+            write_key(out, "cpu_usage_us");
+            write_variant(out, fc::variant(t.cpu_usage_us), deadline);
+            out += ',';
+            write_key(out, "net_usage_words");
+            write_variant(out, fc::variant(t.net_usage_words), deadline);
+            out += ',';
+            write_key(out, "signatures");
+            write_variant(out, fc::variant(t.signatures), deadline);
+            out += ',';
+            write_key(out, "transaction_header");
+            write_variant(out, fc::variant(t.trx_header), deadline);
+         }
+         out += '}';
+      }
+      out += ']';
+   }
+}
+
 namespace eosio::trace_api::detail {
     fc::variant response_formatter::process_block( const data_log_entry& trace, bool irreversible, const data_handler_function& data_handler, const yield_function& yield ) {
        auto common_mvo  = std::visit([&](auto&& arg) -> fc::mutable_variant_object {
@@ -155,4 +305,60 @@ namespace eosio::trace_api::detail {
           return fc::mutable_variant_object();
        }
     }
+
+    void response_formatter::write_block_json( std::string& out, const data_log_entry& trace, bool irreversible, const data_handler_function& data_handler, const yield_function& yield, const fc::time_point& deadline ) {
+       std::visit([&](auto&& arg) {
+          out += '{';
+          write_key(out, "id");
+          write_plain_string(out, arg.id.str());
+          out += ',';
+          write_key(out, "number");
+          out += std::to_string(arg.number);
+          out += ',';
+          write_key(out, "previous_id");
+          write_plain_string(out, arg.previous_id.str());
+          out += ',';
+          write_key(out, "status");
+          write_plain_string(out, irreversible ? "irreversible" : "pending");
+          out += ',';
+          write_key(out, "timestamp");
+          write_plain_string(out, to_iso8601_datetime(arg.timestamp));
+          out += ',';
+          write_key(out, "producer");
+          write_plain_string(out, arg.producer.to_string());
+
+          using T = std::decay_t<decltype(arg)>;
+          if constexpr(!std::is_same_v<T, block_trace_v0>){
+             out += ',';
+             write_key(out, "transaction_mroot");
+             write_plain_string(out, arg.transaction_mroot.str());
+             out += ',';
+             write_key(out, "action_mroot");
+             write_plain_string(out, arg.action_mroot.str());
+             out += ',';
+             write_key(out, "schedule_version");
+             out += std::to_string(arg.schedule_version);
+          }
+
+          out += ',';
+          write_key(out, "transactions");
+          if constexpr(std::is_same_v<T, block_trace_v0>){
+             write_transactions<transaction_trace_v0>(out, arg.transactions, data_handler, yield, deadline);
+          } else if constexpr(std::is_same_v<T, block_trace_v1>){
+             write_transactions<transaction_trace_v1>(out, arg.transactions_v1, data_handler, yield, deadline);
+          } else {
+             write_transactions(out, std::get<std::vector<transaction_trace_v2>>(arg.transactions), data_handler, yield, deadline);
+          }
+          out += '}';
+       }, trace);
+    }
+
+    std::string response_formatter::pack_block( const data_log_entry& trace, bool irreversible ) {
+       fc::datastream<size_t> ps;
+       fc::raw::pack( ps, irreversible, trace );
+       std::string result( ps.tellp(), '\0' );
+       fc::datastream<char*> ds( result.data(), result.size() );
+       fc::raw::pack( ds, irreversible, trace );
+       return result;
+    }
 }
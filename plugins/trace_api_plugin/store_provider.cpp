@@ -30,8 +30,8 @@ namespace {
 
 namespace eosio::trace_api {
    namespace bfs = boost::filesystem;
-   store_provider::store_provider(const bfs::path& slice_dir, uint32_t stride_width, std::optional<uint32_t> minimum_irreversible_history_blocks, std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride)
-   : _slice_directory(slice_dir, stride_width, minimum_irreversible_history_blocks, minimum_uncompressed_irreversible_history_blocks, compression_seek_point_stride) {
+   store_provider::store_provider(const bfs::path& slice_dir, uint32_t stride_width, std::optional<uint32_t> minimum_irreversible_history_blocks, std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride, size_t max_cached_slice_handles, std::optional<bfs::path> archive_dir, std::optional<uint32_t> minimum_unarchived_irreversible_history_blocks)
+   : _slice_directory(slice_dir, stride_width, minimum_irreversible_history_blocks, minimum_uncompressed_irreversible_history_blocks, compression_seek_point_stride, max_cached_slice_handles, std::move(archive_dir), minimum_unarchived_irreversible_history_blocks) {
    }
 
    template<typename BlockTrace>
@@ -87,16 +87,70 @@ namespace eosio::trace_api {
       return std::make_tuple( entry.value(), irreversible );
    }
 
-   slice_directory::slice_directory(const bfs::path& slice_dir, uint32_t width, std::optional<uint32_t> minimum_irreversible_history_blocks, std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride)
+   void store_provider::get_blocks(uint32_t block_height, uint32_t count, const get_blocks_callback& fn, const yield_function& yield) {
+      // block heights are 32 bit, so a range never extends past the last possible height
+      const uint64_t end_height = std::min(static_cast<uint64_t>(block_height) + count, static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()) + 1);
+      uint64_t height = block_height;
+      while (height < end_height) {
+         const uint32_t slice_number = _slice_directory.slice_number(height);
+         const uint64_t slice_end = std::min(end_height, _slice_directory.slice_end(slice_number));
+
+         // a single pass over the index collects every requested block in this slice, the last entry for a
+         // block number wins just as it does for get_block
+         std::map<uint32_t, uint64_t> trace_offsets;
+         std::optional<uint32_t> max_lib;
+         scan_metadata_log_from(height, 0, [&](const metadata_log_entry& e) -> bool {
+            if (std::holds_alternative<block_entry_v0>(e)) {
+               const auto& block = std::get<block_entry_v0>(e);
+               if (block.number >= height && block.number < slice_end) {
+                  trace_offsets[block.number] = block.offset;
+               }
+            } else if (std::holds_alternative<lib_entry_v0>(e)) {
+               auto lib = std::get<lib_entry_v0>(e).lib;
+               if (!max_lib || lib > *max_lib) {
+                  max_lib = lib;
+               }
+            }
+            return true;
+         }, yield);
+
+         if (!trace_offsets.empty()) {
+            std::vector<uint64_t> offsets;
+            offsets.reserve(trace_offsets.size());
+            for (const auto& [number, offset] : trace_offsets) {
+               offsets.push_back(offset);
+            }
+
+            auto number_itr = trace_offsets.cbegin();
+            read_data_log_entries(slice_number, offsets, [&](const data_log_entry& entry) {
+               const bool irreversible = max_lib && *max_lib >= number_itr->first;
+               ++number_itr;
+               fn(entry, irreversible);
+            }, yield);
+         }
+
+         height = slice_end;
+      }
+   }
+
+   slice_directory::slice_directory(const bfs::path& slice_dir, uint32_t width, std::optional<uint32_t> minimum_irreversible_history_blocks, std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride, size_t max_cached_slice_handles, std::optional<bfs::path> archive_dir, std::optional<uint32_t> minimum_unarchived_irreversible_history_blocks)
    : _slice_dir(slice_dir)
    , _width(width)
    , _minimum_irreversible_history_blocks(minimum_irreversible_history_blocks)
    , _minimum_uncompressed_irreversible_history_blocks(minimum_uncompressed_irreversible_history_blocks)
    , _compression_seek_point_stride(compression_seek_point_stride)
+   , _archive_dir(std::move(archive_dir))
+   , _minimum_unarchived_irreversible_history_blocks(minimum_unarchived_irreversible_history_blocks)
+   , _index_handles(max_cached_slice_handles)
+   , _trace_handles(max_cached_slice_handles)
+   , _compressed_trace_handles(max_cached_slice_handles)
    , _best_known_lib(0) {
       if (!exists(_slice_dir)) {
          bfs::create_directories(slice_dir);
       }
+      if (_archive_dir && !exists(*_archive_dir)) {
+         bfs::create_directories(*_archive_dir);
+      }
    }
 
    bool slice_directory::find_or_create_index_slice(uint32_t slice_number, open_state state, fc::cfile& index_file) const {
@@ -163,8 +217,12 @@ namespace eosio::trace_api {
 
    std::optional<compressed_file> slice_directory::find_compressed_trace_slice(uint32_t slice_number, bool open_file ) const {
       auto filename = make_filename(_trace_prefix, _compressed_trace_ext, slice_number, _width);
-      const path slice_path = _slice_dir / filename;
-      const bool file_exists = exists(slice_path);
+      path slice_path = _slice_dir / filename;
+      bool file_exists = exists(slice_path);
+      if (!file_exists && _archive_dir) {
+         slice_path = *_archive_dir / filename;
+         file_exists = exists(slice_path);
+      }
 
       if (file_exists) {
          auto result = compressed_file(slice_path);
@@ -196,6 +254,25 @@ namespace eosio::trace_api {
    }
 
 
+   std::unique_ptr<fc::cfile> slice_directory::open_read_only_slice(uint32_t slice_number, bool index) const {
+      auto filename = make_filename(index ? _trace_index_prefix : _trace_prefix, _trace_ext, slice_number, _width);
+      const path slice_path = _slice_dir / filename;
+      if( !exists(slice_path) ) {
+         return {};
+      }
+
+      auto slice_file = std::make_unique<fc::cfile>();
+      slice_file->set_file_path(slice_path);
+      slice_file->open("rb");
+      return slice_file;
+   }
+
+   void slice_directory::invalidate_cached_slice(uint32_t slice_number) {
+      _index_handles.invalidate(slice_number);
+      _trace_handles.invalidate(slice_number);
+      _compressed_trace_handles.invalidate(slice_number);
+   }
+
    void slice_directory::find_or_create_slice_pair(uint32_t slice_number, open_state state, fc::cfile& trace, fc::cfile& index) {
       const bool trace_found = find_or_create_trace_slice(slice_number, state, trace);
       const bool index_found = find_or_create_index_slice(slice_number, state, index);
@@ -290,6 +367,9 @@ namespace eosio::trace_api {
                log(std::string("Removing: ") + ctrace->get_file_path().generic_string());
                bfs::remove(ctrace->get_file_path());
             }
+
+            // invalidate after removal so a handle opened while removing cannot remain cached
+            invalidate_cached_slice(slice_to_clean);
          });
       }
 
@@ -315,6 +395,36 @@ namespace eosio::trace_api {
                // after compression is complete, delete the old uncompressed file
                log(std::string("Removing: ") + trace.get_file_path().generic_string());
                bfs::remove(trace.get_file_path());
+               invalidate_cached_slice(slice_to_compress);
+            }
+         });
+      }
+
+      // Only process archiving if its configured AND there is a range of compressed irreversible blocks which would
+      // not also be deleted
+      if (_archive_dir && _minimum_unarchived_irreversible_history_blocks &&
+          (!_minimum_irreversible_history_blocks || *_minimum_unarchived_irreversible_history_blocks < *_minimum_irreversible_history_blocks) )
+      {
+         process_irreversible_slice_range(lib, *_minimum_unarchived_irreversible_history_blocks, _last_archived_slice, [this, &log](uint32_t slice_to_archive){
+            const auto filename = make_filename(_trace_prefix, _compressed_trace_ext, slice_to_archive, _width);
+            const path compressed_path = _slice_dir / filename;
+
+            log(std::string("Attempting archive of slice: ") + std::to_string(slice_to_archive));
+
+            if (exists(compressed_path)) {
+               const path archived_path = *_archive_dir / filename;
+               path partial_path = archived_path;
+               partial_path += ".partial";
+
+               // the archive directory is usually on another filesystem so copy rather than rename, the final rename
+               // within the archive directory ensures readers never find a partially written slice
+               log(std::string("Archiving: ") + compressed_path.generic_string() + " to " + archived_path.generic_string());
+               bfs::copy_file(compressed_path, partial_path, bfs::copy_option::overwrite_if_exists);
+               bfs::rename(partial_path, archived_path);
+
+               log(std::string("Removing: ") + compressed_path.generic_string());
+               bfs::remove(compressed_path);
+               invalidate_cached_slice(slice_to_archive);
             }
          });
       }
@@ -29,6 +29,10 @@ struct response_test_fixture {
       get_block_t get_block(uint32_t height, const yield_function& yield= {}) {
          return fixture.mock_get_block(height, yield);
       }
+
+      void get_blocks(uint32_t height, uint32_t count, const get_blocks_callback& fn, const yield_function& yield= {}) {
+         fixture.mock_get_blocks(height, count, fn, yield);
+      }
       response_test_fixture& fixture;
    };
 
@@ -72,8 +76,21 @@ struct response_test_fixture {
       return response_impl.get_block_trace( block_height, yield );
    }
 
+   std::optional<std::string> get_block_trace_json( uint32_t block_height, const yield_function& yield = {} ) {
+      return response_impl.get_block_trace_json( block_height, yield );
+   }
+
+   std::optional<std::string> get_block_trace_packed( uint32_t block_height, const yield_function& yield = {} ) {
+      return response_impl.get_block_trace_packed( block_height, yield );
+   }
+
+   std::string get_blocks_trace_json( uint32_t block_height, uint32_t count, const yield_function& yield = {} ) {
+      return response_impl.get_blocks_trace_json( block_height, count, yield );
+   }
+
    // fixture data and methods
    std::function<get_block_t(uint32_t, const yield_function&)> mock_get_block;
+   std::function<void(uint32_t, uint32_t, const get_blocks_callback&, const yield_function&)> mock_get_blocks;
    std::function<std::tuple<fc::variant, std::optional<fc::variant>>(const action_trace_v0&, const yield_function&)> mock_data_handler_v0 = default_mock_data_handler_v0;
    std::function<std::tuple<fc::variant, std::optional<fc::variant>>(const action_trace_v1&, const yield_function&)> mock_data_handler_v1 = default_mock_data_handler_v1;
 
@@ -1070,4 +1087,230 @@ BOOST_AUTO_TEST_SUITE(trace_responses)
       BOOST_REQUIRE_THROW(get_block_trace( 1, yield ), yield_exception);
    }
 
+   BOOST_FIXTURE_TEST_CASE(json_block_response, response_test_fixture)
+   {
+      auto block_trace = block_trace_v1 {
+         {
+            "b000000000000000000000000000000000000000000000000000000000000001"_h,
+            1,
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            chain::block_timestamp_type(0),
+            "bp.one"_n
+         },
+         "0000000000000000000000000000000000000000000000000000000000000000"_h,
+         "0000000000000000000000000000000000000000000000000000000000000000"_h,
+         0,
+         {
+            {
+               {
+                  "0000000000000000000000000000000000000000000000000000000000000001"_h,
+                  {
+                     {
+                        0x100000000,
+                        "receiver"_n, "contract"_n, "action"_n,
+                        {{ "alice"_n, "active"_n }, { "bob"_n, "owner"_n }},
+                        { 0x01, 0x01, 0x01, 0x01 }
+                     },
+                     {
+                        0,
+                        "receiver"_n, "contract"_n, "action"_n,
+                        {{ "alice"_n, "active"_n }},
+                        { 0x00, 0x00, 0x00, 0x00 }
+                     }
+                  }
+               },
+               fc::enum_type<uint8_t, chain::transaction_receipt_header::status_enum>{chain::transaction_receipt_header::status_enum::executed},
+               10,
+               5,
+               { chain::signature_type() },
+               { chain::time_point(), 1, 0, 100, 50, 0 }
+            }
+         }
+      };
+
+      mock_get_block = [&block_trace]( uint32_t height, const yield_function& ) -> get_block_t {
+         BOOST_TEST(height == 1);
+         return std::make_tuple(data_log_entry(block_trace), true);
+      };
+
+      // the streamed JSON must be identical to serializing the variant response
+      const auto expected_json = fc::json::to_string(get_block_trace( 1 ), fc::time_point::maximum());
+      const auto actual_json = get_block_trace_json( 1 );
+
+      BOOST_REQUIRE(actual_json.has_value());
+      BOOST_TEST(expected_json == *actual_json);
+   }
+
+   BOOST_FIXTURE_TEST_CASE(json_block_response_v2, response_test_fixture)
+   {
+      auto action_trace = action_trace_v1 {
+         {
+            0,
+            "receiver"_n, "contract"_n, "action"_n,
+            {{ "alice"_n, "active"_n }},
+            { 0x00, 0x01, 0x02, 0x03 }
+         },
+         { 0x04, 0x05, 0x06, 0x07 }
+      };
+
+      auto transaction_trace = transaction_trace_v2 {
+         "0000000000000000000000000000000000000000000000000000000000000001"_h,
+         std::vector<action_trace_v1> {
+            action_trace
+         },
+         fc::enum_type<uint8_t, chain::transaction_receipt_header::status_enum>{chain::transaction_receipt_header::status_enum::executed},
+         10,
+         5,
+         std::vector<chain::signature_type>{chain::signature_type()},
+         {chain::time_point(), 1, 0, 100, 50, 0}
+      };
+
+      auto block_trace = block_trace_v2 {
+         "b000000000000000000000000000000000000000000000000000000000000001"_h,
+         1,
+         "0000000000000000000000000000000000000000000000000000000000000000"_h,
+         chain::block_timestamp_type(0),
+         "bp.one"_n,
+         "0000000000000000000000000000000000000000000000000000000000000000"_h,
+         "0000000000000000000000000000000000000000000000000000000000000000"_h,
+         0,
+         std::vector<transaction_trace_v2>{
+            transaction_trace
+         }
+      };
+
+      mock_get_block = [&block_trace]( uint32_t height, const yield_function& ) -> get_block_t {
+         BOOST_TEST(height == 1);
+         return std::make_tuple(data_log_entry(block_trace), false);
+      };
+
+      const auto expected_json = fc::json::to_string(get_block_trace( 1 ), fc::time_point::maximum());
+      const auto actual_json = get_block_trace_json( 1 );
+
+      BOOST_REQUIRE(actual_json.has_value());
+      BOOST_TEST(expected_json == *actual_json);
+   }
+
+   BOOST_FIXTURE_TEST_CASE(json_missing_block_data, response_test_fixture)
+   {
+      mock_get_block = []( uint32_t height, const yield_function& ) -> get_block_t {
+         BOOST_TEST(height == 1);
+         return {};
+      };
+
+      BOOST_TEST(!get_block_trace_json( 1 ).has_value());
+   }
+
+   BOOST_FIXTURE_TEST_CASE(packed_block_response, response_test_fixture)
+   {
+      auto block_trace = block_trace_v2 {
+         "b000000000000000000000000000000000000000000000000000000000000001"_h,
+         1,
+         "0000000000000000000000000000000000000000000000000000000000000000"_h,
+         chain::block_timestamp_type(0),
+         "bp.one"_n,
+         "0000000000000000000000000000000000000000000000000000000000000000"_h,
+         "0000000000000000000000000000000000000000000000000000000000000000"_h,
+         0,
+         std::vector<transaction_trace_v2>{
+            {
+               "0000000000000000000000000000000000000000000000000000000000000001"_h,
+               std::vector<action_trace_v1> {
+                  {
+                     {
+                        0,
+                        "receiver"_n, "contract"_n, "action"_n,
+                        {{ "alice"_n, "active"_n }},
+                        { 0x00, 0x01, 0x02, 0x03 }
+                     },
+                     { 0x04, 0x05, 0x06, 0x07 }
+                  }
+               },
+               fc::enum_type<uint8_t, chain::transaction_receipt_header::status_enum>{chain::transaction_receipt_header::status_enum::executed},
+               10,
+               5,
+               std::vector<chain::signature_type>{chain::signature_type()},
+               {chain::time_point(), 1, 0, 100, 50, 0}
+            }
+         }
+      };
+
+      mock_get_block = [&block_trace]( uint32_t height, const yield_function& ) -> get_block_t {
+         BOOST_TEST(height == 1);
+         return std::make_tuple(data_log_entry(block_trace), true);
+      };
+
+      // the packed form must never consult the data handlers
+      mock_data_handler_v1 = [](const action_trace_v1&, const yield_function&) -> std::tuple<fc::variant, std::optional<fc::variant>> {
+         BOOST_FAIL("data handler called for packed response");
+         return {};
+      };
+
+      const auto packed = get_block_trace_packed( 1 );
+      BOOST_REQUIRE(packed.has_value());
+
+      fc::datastream<const char*> ds( packed->data(), packed->size() );
+      bool irreversible = false;
+      data_log_entry entry;
+      fc::raw::unpack( ds, irreversible );
+      fc::raw::unpack( ds, entry );
+
+      BOOST_TEST(irreversible);
+      BOOST_TEST(ds.remaining() == 0u);
+      BOOST_REQUIRE(std::holds_alternative<block_trace_v2>(entry));
+      BOOST_TEST(fc::raw::pack(entry) == fc::raw::pack(data_log_entry(block_trace)));
+   }
+
+   BOOST_FIXTURE_TEST_CASE(packed_missing_block_data, response_test_fixture)
+   {
+      mock_get_block = []( uint32_t height, const yield_function& ) -> get_block_t {
+         BOOST_TEST(height == 1);
+         return {};
+      };
+
+      BOOST_TEST(!get_block_trace_packed( 1 ).has_value());
+   }
+
+   BOOST_FIXTURE_TEST_CASE(json_blocks_response, response_test_fixture)
+   {
+      auto make_block = [](uint32_t number) {
+         return block_trace_v1 {
+            {
+               fc::sha256::hash(std::to_string(number)),
+               number,
+               "0000000000000000000000000000000000000000000000000000000000000000"_h,
+               chain::block_timestamp_type(0),
+               "bp.one"_n
+            },
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            0,
+            {}
+         };
+      };
+
+      mock_get_block = [&make_block]( uint32_t height, const yield_function& ) -> get_block_t {
+         return std::make_tuple(data_log_entry{make_block(height)}, height <= 2);
+      };
+
+      mock_get_blocks = [&make_block]( uint32_t height, uint32_t count, const get_blocks_callback& fn, const yield_function& ) {
+         BOOST_TEST(height == 1);
+         BOOST_TEST(count == 3);
+         for (uint32_t n = height; n < height + count; ++n) {
+            fn(data_log_entry{make_block(n)}, n <= 2);
+         }
+      };
+
+      const auto expected = fc::json::to_string(fc::variants({get_block_trace(1), get_block_trace(2), get_block_trace(3)}), fc::time_point::maximum());
+      BOOST_TEST(expected == get_blocks_trace_json(1, 3));
+   }
+
+   BOOST_FIXTURE_TEST_CASE(json_blocks_response_empty, response_test_fixture)
+   {
+      mock_get_blocks = []( uint32_t, uint32_t, const get_blocks_callback&, const yield_function& ) {
+      };
+
+      BOOST_TEST(get_blocks_trace_json(1, 3) == "[]");
+   }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -786,6 +786,77 @@ BOOST_AUTO_TEST_SUITE(slice_tests)
       BOOST_REQUIRE_EQUAL(files.size(), 0);
    }
 
+   BOOST_FIXTURE_TEST_CASE(slice_dir_compress_and_archive, test_fixture)
+   {
+      fc::temp_directory tempdir;
+      fc::temp_directory archivedir;
+      const uint32_t width = 10;
+      const uint32_t min_uncompressed_blocks = 5;
+      const uint32_t min_unarchived_blocks = min_uncompressed_blocks + width;
+      slice_directory sd(tempdir.path(), width, std::optional<uint32_t>(), std::optional<uint32_t>(min_uncompressed_blocks), 8,
+                         slice_directory::default_max_cached_slice_handles, archivedir.path(), std::optional<uint32_t>(min_unarchived_blocks));
+      fc::cfile file;
+
+      using file_vector_t = std::vector<std::tuple<bfs::path, bfs::path, bfs::path>>;
+      file_vector_t file_paths;
+      for (int i = 0; i < 7 ; i++) {
+         BOOST_REQUIRE(!sd.find_or_create_index_slice(i, open_state::read, file));
+         auto index_name = file.get_file_path().filename();
+         BOOST_REQUIRE(create_non_empty_trace_slice(sd, i, file));
+         auto trace_name = file.get_file_path().filename();
+         auto compressed_trace_name = trace_name;
+         compressed_trace_name.replace_extension(".clog");
+         file_paths.emplace_back(index_name, trace_name, compressed_trace_name);
+      }
+
+      // initial set is only indices and uncompressed traces
+      std::set<bfs::path> files;
+      std::set<bfs::path> archived_files;
+      for (const auto& e: file_paths) {
+         files.insert(std::get<0>(e));
+         files.insert(std::get<1>(e));
+      }
+      verify_directory_contents(tempdir.path(), files);
+      verify_directory_contents(archivedir.path(), archived_files);
+
+      // verify no change up to the last block before a slice becomes compressible
+      sd.run_maintenance_tasks(14, {});
+      verify_directory_contents(tempdir.path(), files);
+      verify_directory_contents(archivedir.path(), archived_files);
+
+      for (std::size_t reps = 0; reps < file_paths.size() + 1; reps++) {
+         //  leading edge,
+         //  compresses one slice IF its not past the end of our test,
+         if (reps < file_paths.size()) {
+            files.erase(std::get<1>(file_paths.at(reps)));
+            files.insert(std::get<2>(file_paths.at(reps)));
+         }
+
+         // archives one IF its not the first, the index stays behind
+         if (reps > 0) {
+            files.erase(std::get<2>(file_paths.at(reps-1)));
+            archived_files.insert(std::get<2>(file_paths.at(reps-1)));
+         }
+         sd.run_maintenance_tasks(15 + (reps * width), {});
+         verify_directory_contents(tempdir.path(), files);
+         verify_directory_contents(archivedir.path(), archived_files);
+
+         // trailing edge, no change
+         sd.run_maintenance_tasks(24 + (reps * width), {});
+         verify_directory_contents(tempdir.path(), files);
+         verify_directory_contents(archivedir.path(), archived_files);
+      }
+
+      // make sure the test is correct and all traces ended up archived, but are still found
+      for (uint32_t i = 0; i < file_paths.size(); i++) {
+         BOOST_REQUIRE_EQUAL(files.count(std::get<0>(file_paths.at(i))), 1);
+         BOOST_REQUIRE_EQUAL(archived_files.count(std::get<2>(file_paths.at(i))), 1);
+         auto ctrace = sd.find_compressed_trace_slice(i, false);
+         BOOST_REQUIRE(ctrace);
+         BOOST_REQUIRE_EQUAL(ctrace->get_file_path(), archivedir.path() / std::get<2>(file_paths.at(i)));
+      }
+   }
+
    BOOST_FIXTURE_TEST_CASE(store_provider_write_read_v1, test_fixture)
    {
       fc::temp_directory tempdir;
@@ -1070,5 +1141,117 @@ BOOST_AUTO_TEST_SUITE(slice_tests)
       BOOST_REQUIRE(!block2);
    }
 
+   BOOST_FIXTURE_TEST_CASE(test_get_blocks, test_fixture)
+   {
+      fc::temp_directory tempdir;
+      // width of 2 places block 1 in slice 0 and block 5 in slice 2, leaving slice 1 without any files
+      store_provider sp(tempdir.path(), 2, std::optional<uint32_t>(), std::optional<uint32_t>(), 0);
+      sp.append(block_trace1_v2);
+      sp.append_lib(1);
+      sp.append(block_trace2_v2);
+
+      std::vector<std::tuple<data_log_entry, bool>> blocks;
+      auto collect = [&blocks](const data_log_entry& entry, bool irreversible) {
+         blocks.emplace_back(entry, irreversible);
+      };
+
+      sp.get_blocks(0, 10, collect, []() {});
+      BOOST_REQUIRE_EQUAL(blocks.size(), 2);
+      BOOST_REQUIRE_EQUAL(std::get<block_trace_v2>(std::get<0>(blocks[0])), block_trace1_v2);
+      BOOST_REQUIRE(std::get<1>(blocks[0]));
+      BOOST_REQUIRE_EQUAL(std::get<block_trace_v2>(std::get<0>(blocks[1])), block_trace2_v2);
+      BOOST_REQUIRE(!std::get<1>(blocks[1]));
+
+      // the end of the range is exclusive
+      blocks.clear();
+      sp.get_blocks(2, 3, collect, []() {});
+      BOOST_REQUIRE(blocks.empty());
+
+      blocks.clear();
+      sp.get_blocks(2, 4, collect, []() {});
+      BOOST_REQUIRE_EQUAL(blocks.size(), 1);
+      BOOST_REQUIRE_EQUAL(std::get<block_trace_v2>(std::get<0>(blocks[0])), block_trace2_v2);
+
+      // a range reaching past the largest block height must not wrap around
+      blocks.clear();
+      sp.get_blocks(std::numeric_limits<uint32_t>::max() - 1, 10, collect, []() {});
+      BOOST_REQUIRE(blocks.empty());
+
+      int count = 0;
+      try {
+         sp.get_blocks(0, 10, collect, [&count]() {
+            if (++count >= 3) {
+               throw yield_exception("");
+            }
+         });
+         BOOST_FAIL("Should not have completed scan");
+      } catch (const yield_exception& ex) {
+      }
+   }
+
+   BOOST_AUTO_TEST_CASE(test_slice_handle_cache)
+   {
+      slice_handle_cache<int> cache(2);
+
+      auto [empty, gen0] = cache.checkout(1);
+      BOOST_REQUIRE(!empty);
+
+      cache.checkin(1, std::make_unique<int>(10), gen0);
+      cache.checkin(2, std::make_unique<int>(20), gen0);
+      BOOST_REQUIRE_EQUAL(cache.size(), 2);
+
+      auto [one, gen1] = cache.checkout(1);
+      BOOST_REQUIRE(one);
+      BOOST_REQUIRE_EQUAL(*one, 10);
+      BOOST_REQUIRE_EQUAL(cache.size(), 1);
+
+      // invalidating slice 1 while its handle is checked out prevents it being returned
+      cache.invalidate(1);
+      cache.checkin(1, std::move(one), gen1);
+      BOOST_REQUIRE_EQUAL(cache.size(), 1);
+      BOOST_REQUIRE(!std::get<0>(cache.checkout(1)));
+
+      // invalidation closes idle handles of the slice only
+      auto [two, gen2] = cache.checkout(2);
+      BOOST_REQUIRE(two);
+      cache.checkin(2, std::move(two), gen2);
+      cache.invalidate(3);
+      BOOST_REQUIRE_EQUAL(cache.size(), 1);
+      cache.invalidate(2);
+      BOOST_REQUIRE_EQUAL(cache.size(), 0);
+
+      // the least recently checked in handle is evicted when full
+      auto gen3 = std::get<1>(cache.checkout(4));
+      cache.checkin(4, std::make_unique<int>(40), gen3);
+      cache.checkin(5, std::make_unique<int>(50), gen3);
+      cache.checkin(6, std::make_unique<int>(60), gen3);
+      BOOST_REQUIRE_EQUAL(cache.size(), 2);
+      BOOST_REQUIRE(!std::get<0>(cache.checkout(4)));
+      BOOST_REQUIRE(std::get<0>(cache.checkout(5)));
+      BOOST_REQUIRE(std::get<0>(cache.checkout(6)));
+   }
+
+   BOOST_FIXTURE_TEST_CASE(test_get_block_cached_handles, test_fixture)
+   {
+      fc::temp_directory tempdir;
+      store_provider sp(tempdir.path(), 100, std::optional<uint32_t>(), std::optional<uint32_t>(), 0, 1);
+      sp.append(block_trace1_v2);
+      sp.append_lib(1);
+
+      // the first read caches the handles, the second reuses them
+      for (int i = 0; i < 2; ++i) {
+         get_block_t block1 = sp.get_block(1);
+         BOOST_REQUIRE(block1);
+         BOOST_REQUIRE(std::get<1>(*block1));
+         BOOST_REQUIRE_EQUAL(std::get<block_trace_v2>(std::get<0>(*block1)), block_trace1_v2);
+      }
+
+      // data appended after the handles were cached is visible through them
+      sp.append(block_trace2_v2);
+      get_block_t block2 = sp.get_block(5);
+      BOOST_REQUIRE(block2);
+      BOOST_REQUIRE(!std::get<1>(*block2));
+      BOOST_REQUIRE_EQUAL(std::get<block_trace_v2>(std::get<0>(*block2)), block_trace2_v2);
+   }
 
 BOOST_AUTO_TEST_SUITE_END()
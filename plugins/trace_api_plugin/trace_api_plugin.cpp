@@ -87,6 +87,10 @@ namespace {
          return store->get_block(height, yield);
       }
 
+      void get_blocks(uint32_t height, uint32_t count, const get_blocks_callback& fn, const yield_function& yield) {
+         store->get_blocks(height, count, fn, yield);
+      }
+
       std::shared_ptr<Store> store;
    };
 }
@@ -109,6 +113,12 @@ struct trace_api_common_impl {
       cfg_options("trace-minimum-uncompressed-irreversible-history-blocks", boost::program_options::value<int32_t>()->default_value(-1),
                   "Number of blocks to ensure are uncompressed past LIB. Compressed \"slice\" files are still accessible but may carry a performance loss on retrieval\n"
                   "A value of -1 indicates that automatic compression of \"slice\" files will be turned off.");
+      cfg_options("trace-archive-dir", bpo::value<bfs::path>(),
+                  "the location of the directory that compressed \"slice\" files are moved to once they are older than trace-minimum-unarchived-irreversible-history-blocks (absolute path or relative to application data dir).\n"
+                  "Archived \"slice\" files remain accessible.");
+      cfg_options("trace-minimum-unarchived-irreversible-history-blocks", boost::program_options::value<int32_t>()->default_value(-1),
+                  "Number of blocks to ensure are kept in trace-dir past LIB. Only compressed \"slice\" files are archived so this must be greater than or equal to trace-minimum-uncompressed-irreversible-history-blocks\n"
+                  "A value of -1 indicates that automatic archiving of \"slice\" files will be turned off.");
    }
 
    void plugin_initialize(const appbase::variables_map& options) {
@@ -137,12 +147,38 @@ struct trace_api_common_impl {
          minimum_uncompressed_irreversible_history_blocks = uncompressed_blocks;
       }
 
+      const int32_t unarchived_blocks = options.at("trace-minimum-unarchived-irreversible-history-blocks").as<int32_t>();
+      EOS_ASSERT(unarchived_blocks >= -1, chain::plugin_config_exception,
+                 "\"trace-minimum-unarchived-irreversible-history-blocks\" must be greater to or equal to -1.");
+
+      if (unarchived_blocks > manual_slice_file_value) {
+         EOS_ASSERT(options.count("trace-archive-dir"), chain::plugin_config_exception,
+                    "\"trace-minimum-unarchived-irreversible-history-blocks\" requires \"trace-archive-dir\" to be set.");
+         EOS_ASSERT(minimum_uncompressed_irreversible_history_blocks && unarchived_blocks >= static_cast<int32_t>(*minimum_uncompressed_irreversible_history_blocks),
+                    chain::plugin_config_exception,
+                    "\"trace-minimum-unarchived-irreversible-history-blocks\" must be greater to or equal to \"trace-minimum-uncompressed-irreversible-history-blocks\" as only compressed slices are archived.");
+         minimum_unarchived_irreversible_history_blocks = unarchived_blocks;
+      }
+
+      if (options.count("trace-archive-dir")) {
+         auto archive_dir_option = options.at("trace-archive-dir").as<bfs::path>();
+         if (archive_dir_option.is_relative())
+            archive_dir = app().data_dir() / archive_dir_option;
+         else
+            archive_dir = archive_dir_option;
+         if (auto resmon_plugin = app().find_plugin<resource_monitor_plugin>())
+           resmon_plugin->monitor_directory(*archive_dir);
+      }
+
       store = std::make_shared<store_provider>(
          trace_dir,
          slice_stride,
          minimum_irreversible_history_blocks,
          minimum_uncompressed_irreversible_history_blocks,
-         compression_seek_point_stride
+         compression_seek_point_stride,
+         max_cached_slice_handles,
+         archive_dir,
+         minimum_unarchived_irreversible_history_blocks
       );
    }
 
@@ -162,9 +198,12 @@ struct trace_api_common_impl {
 
    std::optional<uint32_t> minimum_irreversible_history_blocks;
    std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks;
+   std::optional<boost::filesystem::path> archive_dir;
+   std::optional<uint32_t> minimum_unarchived_irreversible_history_blocks;
 
    static constexpr int32_t manual_slice_file_value = -1;
    static constexpr uint32_t compression_seek_point_stride = 6 * 1024 * 1024; // 6 MiB strides for clog seek points
+   static constexpr size_t max_cached_slice_handles = 32; // per file type, idle read-only handles kept open for RPC reads
 
    std::shared_ptr<store_provider> store;
 };
@@ -192,6 +231,8 @@ struct trace_api_rpc_plugin_impl : public std::enable_shared_from_this<trace_api
             "Failure to specify this option when there are no trace-rpc-abi configuations will result in an Error.\n"
             "This option is mutually exclusive with trace-rpc-api"
       );
+      cfg_options("trace-rpc-max-block-range", bpo::value<uint32_t>()->default_value(100),
+                  "the maximum number of blocks that can be requested from /v1/trace_api/get_blocks in one call");
    }
 
    void plugin_initialize(const appbase::variables_map& options) {
@@ -220,6 +261,10 @@ struct trace_api_rpc_plugin_impl : public std::enable_shared_from_this<trace_api
       }
 
 
+      max_block_range = options.at("trace-rpc-max-block-range").as<uint32_t>();
+      EOS_ASSERT(max_block_range > 0, chain::plugin_config_exception,
+                 "\"trace-rpc-max-block-range\" must be greater than 0.");
+
       req_handler = std::make_shared<request_handler_t>(
          shared_store_provider<store_provider>(common->store),
          abi_data_handler::shared_provider(data_handler)
@@ -240,8 +285,8 @@ struct trace_api_rpc_plugin_impl : public std::enable_shared_from_this<trace_api
       auto& http = app().get_plugin<http_plugin>();
       fc::microseconds max_response_time = http.get_max_response_time();
 
-      http.add_async_handler("/v1/trace_api/get_block",
-            [wthis=weak_from_this(), max_response_time](std::string, std::string body, url_response_callback cb)
+      http.add_async_raw_handler("/v1/trace_api/get_block",
+            [wthis=weak_from_this(), max_response_time](std::string, std::string body, http_content_type accept, url_response_callback cb, url_raw_response_callback raw_cb)
       {
          auto that = wthis.lock();
          if (!that) {
@@ -274,23 +319,79 @@ struct trace_api_rpc_plugin_impl : public std::enable_shared_from_this<trace_api
          try {
 
             const auto deadline = that->calc_deadline( max_response_time );
-            auto resp = that->req_handler->get_block_trace(*block_number, [deadline]() { FC_CHECK_DEADLINE(deadline); });
-            if (resp.is_null()) {
+            auto yield = [deadline]() { FC_CHECK_DEADLINE(deadline); };
+            auto resp = accept == http_content_type::octet_stream ?
+                        that->req_handler->get_block_trace_packed(*block_number, yield) :
+                        that->req_handler->get_block_trace_json(*block_number, yield, deadline);
+            if (!resp) {
                error_results results{404, "Block trace missing"};
                cb( 404, fc::variant( results ));
             } else {
-               cb( 200, std::move(resp) );
+               raw_cb( 200, std::move(*resp), accept );
             }
          } catch (...) {
             http_plugin::handle_exception("trace_api", "get_block", body, cb);
          }
       });
+
+      http.add_async_raw_handler("/v1/trace_api/get_blocks",
+            [wthis=weak_from_this(), max_response_time](std::string, std::string body, http_content_type accept, url_response_callback cb, url_raw_response_callback raw_cb)
+      {
+         auto that = wthis.lock();
+         if (!that) {
+            return;
+         }
+
+         auto range = ([&body]() -> std::optional<std::tuple<uint32_t, uint32_t>> {
+            if (body.empty()) {
+               return {};
+            }
+
+            try {
+               auto input = fc::json::from_string(body);
+               const auto& obj = input.get_object();
+               auto block_num = obj["block_num"].as_uint64();
+               auto count = obj["count"].as_uint64();
+               if (block_num > std::numeric_limits<uint32_t>::max() || count > std::numeric_limits<uint32_t>::max()) {
+                  return {};
+               }
+               return std::make_tuple(static_cast<uint32_t>(block_num), static_cast<uint32_t>(count));
+            } catch (...) {
+               return {};
+            }
+         })();
+
+         if (!range) {
+            error_results results{400, "Bad or missing block_num or count"};
+            cb( 400, fc::variant( results ));
+            return;
+         }
+
+         const auto [block_num, count] = *range;
+         if (count == 0 || count > that->max_block_range) {
+            error_results results{400, "count must be between 1 and " + std::to_string(that->max_block_range)};
+            cb( 400, fc::variant( results ));
+            return;
+         }
+
+         try {
+            const auto deadline = that->calc_deadline( max_response_time );
+            auto yield = [deadline]() { FC_CHECK_DEADLINE(deadline); };
+            auto resp = accept == http_content_type::octet_stream ?
+                        that->req_handler->get_blocks_trace_packed(block_num, count, yield) :
+                        that->req_handler->get_blocks_trace_json(block_num, count, yield, deadline);
+            raw_cb( 200, std::move(resp), accept );
+         } catch (...) {
+            http_plugin::handle_exception("trace_api", "get_blocks", body, cb);
+         }
+      });
    }
 
    void plugin_shutdown() {
    }
 
    std::shared_ptr<trace_api_common_impl> common;
+   uint32_t max_block_range = 0;
 
    using request_handler_t = request_handler<shared_store_provider<store_provider>, abi_data_handler::shared_provider>;
    std::shared_ptr<request_handler_t> req_handler;
@@ -1,3 +1,4 @@
+#include <eosio/chain/account_object.hpp>
 #include <eosio/chain/controller.hpp>
 #include <eosio/chain/global_property_object.hpp>
 #include <eosio/chain/permission_object.hpp>
@@ -74,4 +75,38 @@ BOOST_AUTO_TEST_CASE( replace_account_keys ) try {
 
 } FC_LOG_AND_RETHROW()
 
+BOOST_AUTO_TEST_CASE( dry_run_transaction ) try {
+   validating_tester tester;
+   tester.produce_block();
+
+   signed_transaction trx;
+   trx.actions.emplace_back( vector<permission_level>{{config::system_account_name, config::active_name}},
+                             newaccount{
+                                .creator  = config::system_account_name,
+                                .name     = "dryrun"_n,
+                                .owner    = authority( tester.get_public_key( "dryrun"_n, "owner" ) ),
+                                .active   = authority( tester.get_public_key( "dryrun"_n, "active" ) ),
+                             });
+   tester.set_transaction_headers( trx );
+   // not signed, authorization is not checked for dry-run
+   auto trx_meta = transaction_metadata::create_no_recover_keys( std::make_shared<packed_transaction>( std::move( trx ), true ),
+                                                                 transaction_metadata::trx_type::dry_run );
+   auto trace = tester.control->push_transaction( trx_meta, fc::time_point::maximum(), 0, false, 0 );
+   BOOST_REQUIRE( !trace->except );
+   BOOST_CHECK( !trace->receipt );
+   BOOST_REQUIRE_EQUAL( trace->action_traces.size(), 1u );
+   BOOST_CHECK( trace->action_traces[0].receipt );
+
+   // rolled back
+   BOOST_CHECK( !tester.control->db().find<account_object, by_name>( "dryrun"_n ) );
+   auto b = tester.produce_block();
+   BOOST_CHECK( b->transactions.empty() );
+   BOOST_CHECK( !tester.control->db().find<account_object, by_name>( "dryrun"_n ) );
+
+   // same transaction can still be applied for real
+   tester.create_account( "dryrun"_n );
+   BOOST_CHECK( tester.control->db().find<account_object, by_name>( "dryrun"_n ) );
+
+} FC_LOG_AND_RETHROW()
+
 BOOST_AUTO_TEST_SUITE_END()
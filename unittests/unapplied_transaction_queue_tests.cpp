@@ -8,13 +8,13 @@ using namespace eosio::chain;
 
 BOOST_AUTO_TEST_SUITE(unapplied_transaction_queue_tests)
 
-auto unique_trx_meta_data( fc::time_point expire = fc::time_point::now() + fc::seconds( 120 ) ) {
+auto unique_trx_meta_data( fc::time_point expire = fc::time_point::now() + fc::seconds( 120 ),
+                           account_name creator = config::system_account_name ) {
 
    static uint64_t nextid = 0;
    ++nextid;
 
    signed_transaction trx;
-   account_name creator = config::system_account_name;
    trx.expiration = expire;
    trx.actions.emplace_back( vector<permission_level>{{creator,config::active_name}},
                              onerror{ nextid, "test", 4 });
@@ -496,4 +496,55 @@ BOOST_AUTO_TEST_CASE( unapplied_transaction_queue_incoming_count ) try {
 
 } FC_LOG_AND_RETHROW() /// unapplied_transaction_queue_incoming_count
 
+BOOST_AUTO_TEST_CASE( unapplied_transaction_queue_lanes ) try {
+
+   const auto expire = fc::time_point::now() + fc::seconds( 120 );
+   unapplied_transaction_queue q;
+   q.set_lanes( trx_lane_type::first_authorizer, 0, { {"bob"_n, 2} } );
+
+   for( size_t i = 0; i < 6; ++i ) q.add_incoming( unique_trx_meta_data( expire, "alice"_n ), false, [](auto){} );
+   for( size_t i = 0; i < 6; ++i ) q.add_incoming( unique_trx_meta_data( expire, "bob"_n ), false, [](auto){} );
+   BOOST_CHECK_EQUAL( q.incoming_size(), 12u );
+
+   auto lanes = q.get_lanes( 10 );
+   BOOST_REQUIRE_EQUAL( lanes.size(), 2u );
+   BOOST_CHECK_EQUAL( lanes[0].count, 6u );
+   BOOST_CHECK_EQUAL( lanes[1].count, 6u );
+
+   // bob is dequeued twice as often as alice even though all of alice's transactions arrived first
+   std::vector<account_name> order;
+   for( auto itr = q.next_incoming(); itr != q.incoming_end(); itr = q.next_incoming() ) {
+      order.push_back( itr->trx_meta->packed_trx()->get_transaction().first_authorizer() );
+      q.erase( itr );
+   }
+   BOOST_REQUIRE_EQUAL( order.size(), 12u );
+   BOOST_CHECK_EQUAL( std::count( order.begin(), order.begin() + 9, "bob"_n ), 6 );
+   BOOST_CHECK_EQUAL( std::count( order.begin() + 9, order.end(), "alice"_n ), 3 );
+   BOOST_CHECK( q.empty() );
+   BOOST_CHECK_EQUAL( q.incoming_size(), 0u );
+   BOOST_CHECK( q.get_lanes( 10 ).empty() );
+
+   // lane size limit only rejects the lane that is over it
+   auto trx = unique_trx_meta_data( expire, "alice"_n );
+   q.add_incoming( trx, false, [](auto){} );
+   auto trx_size = q.get_lanes( 1 ).at( 0 ).size_in_bytes;
+   q.erase( q.next_incoming() );
+
+   q.set_lanes( trx_lane_type::first_authorizer, 2 * trx_size + 1, {} );
+   q.add_incoming( unique_trx_meta_data( expire, "alice"_n ), false, [](auto){} );
+   q.add_incoming( unique_trx_meta_data( expire, "alice"_n ), false, [](auto){} );
+   BOOST_CHECK_THROW( q.add_incoming( unique_trx_meta_data( expire, "alice"_n ), false, [](auto){} ), tx_resource_exhaustion );
+   BOOST_CHECK_EQUAL( q.size(), 2u );
+   q.add_incoming( unique_trx_meta_data( expire, "bob"_n ), false, [](auto){} );
+   BOOST_CHECK_EQUAL( q.incoming_size(), 3u );
+
+   // persisting an incoming transaction removes it from its lane
+   q.add_persisted( q.next_incoming()->trx_meta );
+   BOOST_CHECK_EQUAL( q.incoming_size(), 2u );
+   size_t lane_count = 0;
+   for( const auto& l : q.get_lanes( 10 ) ) lane_count += l.count;
+   BOOST_CHECK_EQUAL( lane_count, 2u );
+
+} FC_LOG_AND_RETHROW() /// unapplied_transaction_queue_lanes
+
 BOOST_AUTO_TEST_SUITE_END()